@@ -4,6 +4,7 @@
 #ifndef SPI_H
 #define SPI_H
 
+#include <map>
 #include <queue>
 
 #include <Arduino.h>
@@ -11,6 +12,7 @@
 #include <gmock/gmock.h>
 
 #include <gos/utils/wordq.h>
+#include <gos/utils/spidevice.h>
 
  // SPI_HAS_TRANSACTION means SPI has beginTransaction(), endTransaction(),
  // usingInterrupt(), and SPISetting(clock, bitOrder, dataMode)
@@ -52,6 +54,13 @@
 #define SPI_MODE2 0x08
 #define SPI_MODE3 0x0C
 
+#ifndef F_CPU
+#define F_CPU 16000000L
+#endif
+
+// Chip select key for bytes transferred while no chip select is low
+#define SPI_NO_CHIP_SELECT 0xff
+
 #define SPI_MODE_MASK 0x0C  // CPOL = bit 3, CPHA = bit 2 on SPCR
 #define SPI_CLOCK_MASK 0x03  // SPR1 = bit 1, SPR0 = bit 0 on SPCR
 #define SPI_2XCLOCK_MASK 0x01  // SPI2X = bit 0 on SPSR
@@ -74,17 +83,34 @@ public:
   SPISettings();
 
   bool operator==(const SPISettings& rhs) const;
+
+  // Effective SCK after the AVR fosc/2..fosc/128 divider selection
+  uint32_t frequency() const;
 private:
   void init(uint32_t clock, uint8_t bitOrder, uint8_t dataMode);
   uint32_t clock_;
   uint8_t bitOrder_;
   uint8_t dataMode_;
+  // The divider is 2 ^^ (clockDiv_ + 1)
+  uint8_t clockDiv_;
   friend class SpiMock;
 };
 
+// Simulated bus usage for one chip select
+struct SpiStatistics {
+  SpiStatistics();
+  uint64_t Bytes;
+  uint64_t Transactions;
+  uint64_t Nanoseconds;
+  double microseconds() const;
+};
+
 class SpiMock {
 public:
   typedef std::queue<SPISettings> QueueSettings;
+  typedef ::gos::arduino::testing::utils::spi::Device Device;
+  typedef std::map<uint8_t, Device*> DeviceMap;
+  typedef std::map<uint8_t, SpiStatistics> StatisticsMap;
 
   // Initialize the SPI library
   //static void begin();
@@ -124,6 +150,8 @@ public:
 
   //inline static void transfer(void *buf, size_t count);
   //MOCK_METHOD2(transfer, void(void *buf, size_t count));
+  // Full duplex, the bytes in buf are queued to In and replaced with
+  // bytes from Out. When Out runs dry the remainder is set to Fill.
   void transfer(void *buf, size_t count);
 
   //inline static void endTransaction(void);
@@ -157,9 +185,51 @@ public:
   MOCK_METHOD0(attachInterrupt, void(void));
   MOCK_METHOD0(detachInterrupt, void(void));
 
+  SpiMock();
+
+  // Attach a device model to a chip select pin. The mock does not take
+  // ownership. While the device is selected its transfer replaces Out.
+  void attach(uint8_t pin, Device* device);
+  void detach(uint8_t pin);
+
+  // Chip select observer with the digitalWrite signature so it can be
+  // invoked from the Arduino mock, for example
+  // EXPECT_CALL(*arduinomock, digitalWrite(pin, testing::_))
+  //   .WillRepeatedly(testing::Invoke(spimock, &SpiMock::chipselect));
+  // Every chip select assertion counts as a transaction for the pin.
+  void chipselect(uint8_t pin, uint8_t value);
+
+  // Settings of the innermost open transaction or the default settings
+  const SPISettings& settings() const;
+
   ::gos::arduino::testing::utils::WordQueue In;
   ::gos::arduino::testing::utils::WordQueue Out;
   QueueSettings TransactionQueue;
+
+  // Byte clocked in when Out has nothing left to give
+  uint8_t Fill;
+  // Number of bytes that have been filled because Out was empty
+  uint64_t Underrun;
+  // Capture MOSI bytes into In, turn off for long streaming runs
+  bool Capture;
+  // Bytes exchanged with a selected device in a SPI mode it does not
+  // support. In and Out hold bytes in wire order, MSB first, so with
+  // LSBFIRST settings they are bit reversed compared to the values.
+  uint64_t Mismatch;
+  DeviceMap Devices;
+
+  // Virtual bus clock, the total simulated bus busy time
+  uint64_t Nanoseconds;
+  // Bus usage per chip select pin
+  StatisticsMap Statistics;
+
+private:
+  void account(const size_t& bytes);
+  void exchange(uint8_t* bytes, const size_t& count);
+
+  SPISettings default_;
+  Device* selected_;
+  uint8_t chipselect_;
 };
 
 class Spi_ {
@@ -181,6 +251,8 @@ public:
 };
 extern Spi_ SPI;
 
+// The SPI mock instance is thread local, SPI forwards to the instance
+// created by the calling thread
 SpiMock* spiMockInstance();
 void releaseSpiMock();
 
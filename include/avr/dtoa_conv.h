@@ -37,6 +37,10 @@ int dtoa_prf (double val, char *s, unsigned char width, unsigned char prec,
               unsigned char flags);
 int dtoa_prf_f(float val, char *s, unsigned char width, unsigned char prec,
   unsigned char flags);
+/* Double precision, dtoa_prf uses it in place of the float path when
+   DTOA_PRF_DOUBLE is defined */
+int dtoa_prf_d(double val, char *s, unsigned char width, unsigned char prec,
+  unsigned char flags);
 //int dtoa_lim (double val, char *s, unsigned char width, unsigned char prec,
 //              unsigned char flags);
 //int dtoa_cln (double val, char *s, unsigned char ndigs, unsigned char flags);
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Double precision counterpart of ftoa_engine for host builds. Writes the
+ * fixed notation of |val| with prec decimals to buf + 1, rounded to
+ * nearest even from the exact binary value as printf does, and the
+ * FTOA_ flags to buf[0]. Returns the number of characters after the
+ * flags, 0 for NaN and infinity. buf must hold DTOA_ENGINE_BUFFER bytes.
+ */
+int16_t dtoa_engine(double val, char *buf, uint8_t prec);
+
+/* Flags, 309 integer digits, the point, 255 decimals and a terminator */
+#define DTOA_ENGINE_BUFFER 567
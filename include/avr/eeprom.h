@@ -6,17 +6,63 @@
 
 #include <memory>
 #include <execution>
+#include <vector>
+
+/* Atmel specifies 3.3 ms for an erase and write cycle of one cell */
+#ifndef AVR_EEPROM_MOCK_WRITE_NANOSECONDS
+#define AVR_EEPROM_MOCK_WRITE_NANOSECONDS 3300000
+#endif
+/* Specified endurance in erase and write cycles of one cell */
+#ifndef AVR_EEPROM_MOCK_ENDURANCE
+#define AVR_EEPROM_MOCK_ENDURANCE 100000
+#endif
 
 
 namespace avr {
 namespace mock {
+/* Frees the EEPROM image, unmaps it when it is backed by a file */
+struct Release {
+  Release(const size_t& mapped = 0);
+  void operator()(uint8_t* pointer) const;
+  size_t mapped;
+};
+typedef std::unique_ptr<uint8_t[], Release> Buffer;
+/* Erase and write cycle count of each cell since initialize or reset */
+typedef std::vector<uint32_t> Counters;
+struct Cell {
+  size_t address;
+  uint32_t writes;
+};
+typedef std::vector<Cell> Cells;
 extern size_t size;
-extern std::unique_ptr<uint8_t[]> buffer;
+extern Buffer buffer;
+extern Counters writes;
 class AvrMockException : public std::exception {
   const char* what() const noexcept override {
     return "AVR Mock not initialized or out of range";
   }
 };
+/* Heap backed image, lost when the process exits */
+void initialize(const size_t& size);
+/*
+ * Image backed by a shared memory mapping of the file at path so it
+ * survives between test processes. The file is created or extended to
+ * size and new bytes are erased to 0xff. Returns false on failure.
+ */
+bool initialize(const size_t& size, const char* path);
+/* Flush a file backed image to disk */
+void sync();
+void release();
+/* Wear accounting, cleared by initialize and reset */
+void reset();
+/* Total erase and write cycles over all cells */
+uint64_t cycles();
+/* Simulated time spent erasing and writing */
+uint64_t nanoseconds();
+/* The count most written cells, most written first */
+Cells hottest(const size_t& count);
+/* Cells written more often than the specified endurance */
+size_t worn();
 }
 }
 
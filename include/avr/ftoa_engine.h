@@ -30,6 +30,9 @@
 
 int16_t ftoa_engine(float val, char *buf,
   uint8_t precision, uint8_t maxDecimals);
+/* The original digit loop, ftoa_engine gives the same result faster */
+int16_t ftoa_engine_reference(float val, char *buf,
+  uint8_t precision, uint8_t maxDecimals);
 
 /* '__ftoa_engine' return next flags (in buf[0]):	*/
 #define	FTOA_MINUS	1
@@ -0,0 +1,52 @@
+#ifndef _GOS_ARDUINO_TESTING_UTILS_BITS_H_
+#define _GOS_ARDUINO_TESTING_UTILS_BITS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <vector>
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace utils {
+
+/*
+ * Bit array packed into 64-bit words. Ranges move to and from the
+ * Modbus coil byte layout, first bit in the least significant bit of
+ * the first byte, a word at a time.
+ */
+class Bits {
+public:
+  Bits(const size_t& count = 0);
+
+  size_t size() const;
+  /* New bits are cleared */
+  void resize(const size_t& count);
+  void fill(const bool& value);
+
+  bool get(const size_t& index) const;
+  void set(const size_t& index, const bool& value);
+  bool operator[](const size_t& index) const;
+
+  /* Write count bits from index to destination, (count + 7) / 8 bytes */
+  void pack(uint8_t* destination, size_t index, size_t count) const;
+  /* Read count bits from source to index */
+  void unpack(const uint8_t* source, size_t index, size_t count);
+
+private:
+  /* 64 bits starting at any bit index, bits past the end are zero */
+  uint64_t extract(const size_t& index) const;
+  /* Replace the bits of mask starting at any bit index */
+  void insert(const size_t& index, const uint64_t& value, const uint64_t& mask);
+
+  std::vector<uint64_t> words_;
+  size_t count_;
+};
+
+}
+}
+}
+}
+
+#endif
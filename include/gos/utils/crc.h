@@ -0,0 +1,176 @@
+#ifndef _GOS_ARDUINO_TESTING_UTILS_CRC_H_
+#define _GOS_ARDUINO_TESTING_UTILS_CRC_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace utils {
+namespace crc {
+
+/*
+ * Reflected CRC engines. The policy selects the algorithm, the result is
+ * the same for all of them:
+ *
+ *   Bitwise  one shift per bit, the reference the others are tested against
+ *   Table    one 256 entry table lookup per byte
+ *   Slicing  slicing-by-8, eight table lookups per eight bytes
+ *
+ * The tables are generated at compile time. On the AVR target the table
+ * would go to PROGMEM, on the host a constexpr table is all we need.
+ */
+namespace policy {
+struct Bitwise {};
+struct Table {};
+struct Slicing {};
+}
+
+namespace details {
+
+enum {
+  TableSize = 256,
+  SliceCount = 8
+};
+
+/* Entry k of slice s is the CRC of byte k followed by s zero bytes */
+template<typename T> struct Slices {
+  T entries[SliceCount][TableSize];
+};
+
+template<typename T, T Polynomial> constexpr T entry(const unsigned& index) {
+  T crc = static_cast<T>(index);
+  for (int i = 0; i < 8; i++) {
+    crc = (crc & 1) ? static_cast<T>((crc >> 1) ^ Polynomial) :
+      static_cast<T>(crc >> 1);
+  }
+  return crc;
+}
+
+template<typename T, T Polynomial> constexpr Slices<T> generate() {
+  Slices<T> slices = {};
+  for (unsigned i = 0; i < TableSize; i++) {
+    slices.entries[0][i] = entry<T, Polynomial>(i);
+  }
+  for (unsigned s = 1; s < SliceCount; s++) {
+    for (unsigned i = 0; i < TableSize; i++) {
+      T previous = slices.entries[s - 1][i];
+      slices.entries[s][i] = static_cast<T>(
+        (previous >> 8) ^ slices.entries[0][previous & 0xff]);
+    }
+  }
+  return slices;
+}
+
+template<typename T, T Polynomial> struct Lookup {
+  static constexpr Slices<T> value = generate<T, Polynomial>();
+};
+
+template<typename T, T Polynomial>
+constexpr Slices<T> Lookup<T, Polynomial>::value;
+
+template<typename T, T Polynomial> T update(
+  T crc,
+  const uint8_t* data,
+  size_t size,
+  const policy::Bitwise&) {
+  while (size-- > 0) {
+    crc ^= *data++;
+    for (int i = 0; i < 8; i++) {
+      crc = (crc & 1) ? static_cast<T>((crc >> 1) ^ Polynomial) :
+        static_cast<T>(crc >> 1);
+    }
+  }
+  return crc;
+}
+
+template<typename T, T Polynomial> T update(
+  T crc,
+  const uint8_t* data,
+  size_t size,
+  const policy::Table&) {
+  const T* table = Lookup<T, Polynomial>::value.entries[0];
+  while (size-- > 0) {
+    crc = static_cast<T>((crc >> 8) ^ table[(crc ^ *data++) & 0xff]);
+  }
+  return crc;
+}
+
+template<typename T, T Polynomial> T update(
+  T crc,
+  const uint8_t* data,
+  size_t size,
+  const policy::Slicing&) {
+  const Slices<T>& slices = Lookup<T, Polynomial>::value;
+  while (size >= SliceCount) {
+    /* Assembled byte by byte so the lane is little endian on any host */
+    uint64_t lane = 0;
+    for (int i = SliceCount - 1; i >= 0; i--) {
+      lane = (lane << 8) | data[i];
+    }
+    lane ^= crc;
+    crc = static_cast<T>(
+      slices.entries[7][lane & 0xff] ^
+      slices.entries[6][(lane >> 8) & 0xff] ^
+      slices.entries[5][(lane >> 16) & 0xff] ^
+      slices.entries[4][(lane >> 24) & 0xff] ^
+      slices.entries[3][(lane >> 32) & 0xff] ^
+      slices.entries[2][(lane >> 40) & 0xff] ^
+      slices.entries[1][(lane >> 48) & 0xff] ^
+      slices.entries[0][lane >> 56]);
+    data += SliceCount;
+    size -= SliceCount;
+  }
+  return update<T, Polynomial>(crc, data, size, policy::Table());
+}
+
+}
+
+template<
+  typename T,
+  T Polynomial,
+  T Initial,
+  T Final,
+  typename P = policy::Table>
+class Engine {
+public:
+  typedef T Type;
+
+  /* Continue a calculation started with initial() */
+  static T update(const T& crc, const void* data, const size_t& size) {
+    return details::update<T, Polynomial>(
+      crc,
+      static_cast<const uint8_t*>(data),
+      size,
+      P());
+  }
+
+  static T initial() {
+    return Initial;
+  }
+
+  static T finalize(const T& crc) {
+    return static_cast<T>(crc ^ Final);
+  }
+
+  static T calculate(const void* data, const size_t& size) {
+    return finalize(update(Initial, data, size));
+  }
+};
+
+/* CRC-32 as used by zip and Ethernet */
+template<typename P = policy::Table> using Crc32 =
+  Engine<uint32_t, 0xedb88320, 0xffffffff, 0xffffffff, P>;
+
+/* Modbus RTU CRC-16, the low byte goes first on the wire */
+template<typename P = policy::Table> using Modbus =
+  Engine<uint16_t, 0xa001, 0xffff, 0x0000, P>;
+
+}
+}
+}
+}
+}
+
+#endif
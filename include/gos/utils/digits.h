@@ -0,0 +1,41 @@
+#ifndef _GOS_ARDUINO_TESTING_UTILS_DIGITS_H_
+#define _GOS_ARDUINO_TESTING_UTILS_DIGITS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+/* 64 binary digits, a sign and a terminator */
+#define GOS_ARDUINO_TESTING_DIGITS_BUFFER 66
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace utils {
+namespace digits {
+
+/*
+ * Writes the digits of value in base right aligned so they end just
+ * before end and returns the first one. Nothing is terminated. Base 10
+ * goes two digits at a time from a table, power of two bases by shift
+ * and mask, a base outside 2 to 36 is taken as 10.
+ */
+char* format(
+  const uint64_t& value,
+  char* end,
+  const uint8_t& base = 10,
+  const bool& upper = true);
+
+/* As format with a minus ahead of a negative value */
+char* formatsigned(
+  const int64_t& value,
+  char* end,
+  const uint8_t& base = 10,
+  const bool& upper = true);
+
+}
+}
+}
+}
+}
+
+#endif
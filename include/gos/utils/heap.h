@@ -0,0 +1,68 @@
+#ifndef _GOS_ARDUINO_TESTING_UTILS_HEAP_H_
+#define _GOS_ARDUINO_TESTING_UTILS_HEAP_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <map>
+#include <vector>
+
+/* Bytes ahead of every chunk holding its size, as in avr-libc malloc */
+#define GOS_ARDUINO_TESTING_HEAP_HEADER 2
+/* Largest heap, the address space of an AVR, so every chunk fits a header */
+#define GOS_ARDUINO_TESTING_HEAP_LIMIT 65536
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace utils {
+
+/*
+ * Fixed size heap that allocates the way avr-libc malloc does, best fit
+ * from the free list else from the break, so host runs run out of
+ * memory and fragment where a device would.
+ */
+class Heap {
+public:
+  /* A size above GOS_ARDUINO_TESTING_HEAP_LIMIT is capped to it */
+  Heap(const size_t& size);
+
+  /* nullptr when the heap is exhausted or the size can never fit */
+  void* allocate(const size_t& size);
+  /* nullptr when the chunk cannot grow, the chunk is left as it is */
+  void* reallocate(void* pointer, const size_t& size);
+  void release(void* pointer);
+
+  bool owns(const void* pointer) const;
+  size_t size() const;
+  /* Bytes in allocated chunks, headers included */
+  size_t used() const;
+  /* Highest break so far */
+  size_t peak() const;
+  /* Largest allocation that would succeed now */
+  size_t largest() const;
+
+  uint64_t Allocations;
+  uint64_t Failures;
+
+private:
+  size_t offset(const void* pointer) const;
+  size_t chunk(const size_t& offset) const;
+  void* place(const size_t& offset, const size_t& size);
+  /* Return a chunk to the free list or below the break */
+  void free(const size_t& offset, const size_t& size);
+
+  std::vector<uint8_t> memory_;
+  /* Free chunks by offset, headers included */
+  std::map<size_t, size_t> free_;
+  size_t break_;
+  size_t used_;
+  size_t peak_;
+};
+
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef _GOS_ARDUINO_TESTING_UTILS_HISTOGRAM_H_
+#define _GOS_ARDUINO_TESTING_UTILS_HISTOGRAM_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <ostream>
+#include <vector>
+
+#define GOS_ARDUINO_TESTING_HISTOGRAM_SIGNIFICANT_BITS 5
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace utils {
+
+/*
+ * HDR style histogram of unsigned values. Values below 2^significant get
+ * a bucket each and every following power of two range is split into
+ * 2^(significant-1) buckets, so the relative error of a reported value
+ * stays below 2^(1-significant) over the whole 64-bit range.
+ */
+class Histogram {
+public:
+  Histogram(
+    const uint8_t& significant = GOS_ARDUINO_TESTING_HISTOGRAM_SIGNIFICANT_BITS);
+
+  void record(const uint64_t& value, const uint64_t& count = 1);
+  void clear();
+
+  uint64_t count() const;
+  uint64_t minimum() const;
+  uint64_t maximum() const;
+  double mean() const;
+
+  /* Value at or below which percent of the recorded values fall */
+  uint64_t percentile(const double& percent) const;
+
+  /* Count, mean and the usual percentiles on one line */
+  void report(std::ostream& stream, const char* unit = "") const;
+
+private:
+  size_t index(const uint64_t& value) const;
+  /* Highest value that lands in the bucket */
+  uint64_t highest(const size_t& index) const;
+
+  uint8_t significant_;
+  std::vector<uint64_t> counts_;
+  uint64_t count_;
+  uint64_t minimum_;
+  uint64_t maximum_;
+  double sum_;
+};
+
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef _GOS_ARDUINO_TESTING_UTILS_LCG_H_
+#define _GOS_ARDUINO_TESTING_UTILS_LCG_H_
+
+#include <cstdint>
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace utils {
+namespace lcg {
+
+/*
+ * Advance state by the 64 bit linear congruential generator of MMIX and
+ * return it. Tests seed it for a sequence that is the same on every host
+ * without going through the Arduino random.
+ */
+inline uint64_t next(uint64_t& state) {
+  state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return state;
+}
+
+}
+}
+}
+}
+}
+
+#endif
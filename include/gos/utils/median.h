@@ -0,0 +1,95 @@
+#ifndef _GOS_ARDUINO_TESTING_UTILS_MEDIAN_H_
+#define _GOS_ARDUINO_TESTING_UTILS_MEDIAN_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <vector>
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace utils {
+namespace statistics {
+
+/*
+ * Median of the last size samples kept up to date as samples arrive.
+ * Values holds the window in the slot order of gatl statistics::Set and
+ * a sorted copy sits next to it. add finds the outgoing and incoming
+ * positions by binary search and shifts only the samples between them,
+ * so get is a lookup instead of a sort. NaN samples are not supported.
+ */
+template<typename T, typename I = uint8_t>
+class RunningMedian {
+public:
+  RunningMedian(const I& size) :
+    Count(0),
+    size_(size),
+    index_(0) {
+    Values.reserve(size);
+    sorted_.reserve(size);
+  }
+
+  void add(const T& value) {
+    if (Count < size_) {
+      Values.push_back(value);
+      sorted_.insert(
+        std::upper_bound(sorted_.begin(), sorted_.end(), value), value);
+      Count++;
+      return;
+    }
+
+    T outgoing = Values[index_];
+    Values[index_] = value;
+    index_ = index_ < size_ - 1 ? index_ + 1 : 0;
+
+    typename std::vector<T>::iterator at =
+      std::lower_bound(sorted_.begin(), sorted_.end(), outgoing);
+    if (outgoing < value) {
+      typename std::vector<T>::iterator to =
+        std::lower_bound(at + 1, sorted_.end(), value);
+      std::copy(at + 1, to, at);
+      *(to - 1) = value;
+    } else {
+      typename std::vector<T>::iterator to =
+        std::upper_bound(sorted_.begin(), at, value);
+      std::copy_backward(to, at, at + 1);
+      *to = value;
+    }
+  }
+
+  /* Mean of the two middle samples when the count is even */
+  T get() const {
+    if (Count == 0) {
+      return T();
+    }
+    if (Count % 2) {
+      return sorted_[Count / 2];
+    }
+    return (sorted_[Count / 2] + sorted_[Count / 2 - 1]) / T(2);
+  }
+
+  void clear() {
+    Values.clear();
+    sorted_.clear();
+    Count = 0;
+    index_ = 0;
+  }
+
+  I Count;
+  std::vector<T> Values;
+
+private:
+  I size_;
+  I index_;
+  std::vector<T> sorted_;
+};
+
+}
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef _GOS_ARDUINO_TESTING_UTILS_MODBUS_H_
+#define _GOS_ARDUINO_TESTING_UTILS_MODBUS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <map>
+#include <ostream>
+
+#include <gos/utils/histogram.h>
+
+#define GOS_ARDUINO_TESTING_MODBUS_FRAME_SIZE 256
+#define GOS_ARDUINO_TESTING_MODBUS_MBAP_SIZE 7
+#define GOS_ARDUINO_TESTING_MODBUS_ADU_SIZE 260
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace utils {
+namespace modbus {
+
+/*
+ * Modbus RTU master side of a test. The request functions write a
+ * complete frame including the CRC and return its length.
+ */
+namespace master {
+size_t read(
+  uint8_t* frame,
+  const uint8_t& id,
+  const uint8_t& function,
+  const uint16_t& address,
+  const uint16_t& count);
+size_t write(
+  uint8_t* frame,
+  const uint8_t& id,
+  const uint16_t& address,
+  const uint16_t* values,
+  const uint16_t& count);
+/* Response length expected for a request, 0 for a broadcast */
+size_t expected(const uint8_t* request, const size_t& length);
+bool valid(const uint8_t* frame, const size_t& length);
+bool exception(const uint8_t* frame, const size_t& length);
+}
+
+/*
+ * Modbus TCP framing. An ADU is the MBAP header, transaction identifier,
+ * protocol identifier 0 and the length of the rest, then the unit and
+ * the PDU. It carries an RTU frame without the CRC.
+ */
+namespace tcp {
+/* Wrap an RTU frame, returns the ADU length */
+size_t wrap(
+  uint8_t* adu,
+  const uint16_t& transaction,
+  const uint8_t* frame,
+  const size_t& length);
+/* Back to an RTU frame with a CRC, returns the frame length */
+size_t unwrap(uint8_t* frame, const uint8_t* adu, const size_t& length);
+/* ADU length from the bytes received so far, 0 when unknown */
+size_t expected(const uint8_t* adu, const size_t& length);
+uint16_t transaction(const uint8_t* adu);
+}
+
+/*
+ * Request mix of a load run. The generator cycles read coils, read
+ * holding registers and write multiple registers with the given weights
+ * and rolls the address over the window of the register map.
+ */
+struct Mix {
+  uint8_t Id;
+  uint16_t Address;
+  uint16_t Window;
+  uint16_t Count;
+  uint8_t ReadCoils;
+  uint8_t ReadHolding;
+  uint8_t WriteMultiple;
+};
+
+class Generator {
+public:
+  Generator(const Mix& mix);
+
+  /* Next request, returns the frame length */
+  size_t next(uint8_t* frame);
+
+private:
+  Mix mix_;
+  uint32_t sequence_;
+  uint16_t offset_;
+};
+
+struct Load;
+
+/*
+ * Pipelined Modbus TCP master connection. Up to depth requests are
+ * outstanding, each under its own transaction identifier, and responses
+ * are matched in any order.
+ */
+class Session {
+public:
+  Session(const size_t& depth);
+
+  /* Next request of the generator as an ADU, 0 when the pipe is full */
+  size_t request(uint8_t* adu, Generator& generator, const uint64_t& time);
+  /*
+   * False when the transaction is not outstanding or the ADU is not well
+   * formed, a protocol other than 0 or a length field not matching what
+   * was received. A malformed ADU counts as invalid and its transaction
+   * stays outstanding.
+   */
+  bool response(
+    const uint8_t* adu,
+    const size_t& length,
+    const uint64_t& time,
+    Load& load);
+
+  size_t outstanding() const;
+
+private:
+  size_t depth_;
+  uint16_t transaction_;
+  /* Send time by transaction */
+  std::map<uint16_t, uint64_t> pending_;
+};
+
+/* Outcome of a load run, latency in virtual microseconds */
+struct Load {
+  Load();
+
+  void request(const size_t& bytes);
+  void response(
+    const uint8_t* frame,
+    const size_t& length,
+    const uint64_t& latency);
+  void timeout();
+
+  /* Completed requests per second of virtual time */
+  double throughput() const;
+  double exceptionrate() const;
+  void report(std::ostream& stream) const;
+
+  Histogram Latency;
+  uint64_t Requests;
+  uint64_t Responses;
+  uint64_t Exceptions;
+  uint64_t Invalid;
+  uint64_t Timeouts;
+  uint64_t BytesSent;
+  uint64_t BytesReceived;
+  uint64_t Elapsed;
+};
+
+}
+}
+}
+}
+}
+
+#endif
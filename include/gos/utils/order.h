@@ -1,6 +1,7 @@
 #ifndef _GOS_ARDUINO_TESTING_UTILS_ORDER_H_
 #define _GOS_ARDUINO_TESTING_UTILS_ORDER_H_
 
+#include <cstddef>
 #include <cstdint>
 
 namespace gos {
@@ -17,6 +18,14 @@ Order contrary(const Order& order);
 uint16_t combine(const uint8_t& first, const uint8_t& second, const Order& order = Order::BigEndian);
 uint8_t fyrstbyte(const uint16_t& word, const Order& order = Order::BigEndian);
 uint8_t secondbyte(const uint16_t& word, const Order& order = Order::BigEndian);
+Order host();
+/*
+ * Copy count words to and from bytes in order, a register block of a
+ * Modbus frame, swapping eight bytes at a time when order is not the
+ * host order
+ */
+void store(uint8_t* destination, const uint16_t* words, const size_t& count, const Order& order = Order::BigEndian);
+void load(uint16_t* words, const uint8_t* source, const size_t& count, const Order& order = Order::BigEndian);
 }
 namespace bit {
 enum class Order {
@@ -24,6 +33,17 @@ enum class Order {
   MsbFirst = 1,
   LsbFirst = 2
 };
+uint8_t reverse(const uint8_t& value);
+/* Reverse the bit order of every byte in place, eight bytes at a time */
+void reverse(uint8_t* data, const size_t& count);
+}
+namespace word {
+/* Order of the 16-bit registers holding a wider value */
+enum class Order {
+  Undefined = 0,
+  LowFirst = 1,
+  HighFirst = 2
+};
 }
 }
 }
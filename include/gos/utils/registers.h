@@ -0,0 +1,84 @@
+#ifndef _GOS_ARDUINO_TESTING_UTILS_REGISTERS_H_
+#define _GOS_ARDUINO_TESTING_UTILS_REGISTERS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <gos/utils/order.h>
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace utils {
+namespace registers {
+
+/* Number of 16-bit registers holding a value of type T */
+template<typename T> struct Width {
+  static_assert(sizeof(T) % 2 == 0, "Values must fill whole registers");
+  static constexpr size_t value = sizeof(T) / 2;
+};
+
+namespace details {
+/* Word order of a wider value as it sits in host memory */
+inline word::Order host() {
+  const uint16_t probe = 1;
+  uint8_t first;
+  ::memcpy(&first, &probe, 1);
+  return first == 1 ? word::Order::LowFirst : word::Order::HighFirst;
+}
+}
+
+/*
+ * Map count values of type T, float, int32_t, SQ15x16 and the like, to
+ * count * Width<T>::value contiguous registers. When the word order is
+ * the host order the whole run is a single copy, otherwise the words of
+ * each value are reversed on the way.
+ */
+template<typename T>
+void put(
+  uint16_t* registers,
+  const T* values,
+  const size_t& count,
+  const word::Order& order = word::Order::LowFirst) {
+  const size_t width = Width<T>::value;
+  if (width == 1 || order == details::host()) {
+    ::memcpy(registers, values, count * sizeof(T));
+    return;
+  }
+  uint16_t words[width];
+  for (size_t n = 0; n < count; n++) {
+    ::memcpy(words, values + n, sizeof(T));
+    for (size_t w = 0; w < width; w++) {
+      *registers++ = words[width - 1 - w];
+    }
+  }
+}
+
+template<typename T>
+void get(
+  T* values,
+  const uint16_t* registers,
+  const size_t& count,
+  const word::Order& order = word::Order::LowFirst) {
+  const size_t width = Width<T>::value;
+  if (width == 1 || order == details::host()) {
+    ::memcpy(values, registers, count * sizeof(T));
+    return;
+  }
+  uint16_t words[width];
+  for (size_t n = 0; n < count; n++) {
+    for (size_t w = 0; w < width; w++) {
+      words[width - 1 - w] = *registers++;
+    }
+    ::memcpy(values + n, words, sizeof(T));
+  }
+}
+
+}
+}
+}
+}
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef _GOS_ARDUINO_TESTING_UTILS_RTU_H_
+#define _GOS_ARDUINO_TESTING_UTILS_RTU_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <deque>
+
+#include <gos/utils/wordq.h>
+
+/* Start, eight data, parity or second stop and stop bit */
+#define GOS_ARDUINO_TESTING_RTU_CHARACTER_BITS 11
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace utils {
+namespace rtu {
+
+/*
+ * Modbus RTU timing for a baud rate in microseconds. Above 19200 baud
+ * the specification fixes t1.5 at 750 us and t3.5 at 1750 us.
+ */
+struct Timing {
+  Timing(
+    const uint32_t& rate,
+    const uint8_t& bits = GOS_ARDUINO_TESTING_RTU_CHARACTER_BITS);
+  uint32_t Character;
+  /* t1.5, the longest gap allowed between characters of a frame */
+  uint32_t Interchar;
+  /* t3.5, the silence that ends a frame */
+  uint32_t Interframe;
+};
+
+/*
+ * Virtual time in microseconds. Hand micros() to the Arduino mock with
+ * Invoke(&clock, &Clock::micros) so code under test sees the same time
+ * as the lines.
+ */
+class Clock {
+public:
+  Clock();
+
+  unsigned long micros() const;
+  void advance(const uint64_t& microseconds);
+  /* Move forward to time, never backwards */
+  void until(const uint64_t& time);
+
+  uint64_t Now;
+};
+
+/*
+ * One direction of a serial line in virtual time. Sent bytes are
+ * queued back to back after the previous burst and become available to
+ * the receiver one character time apart as the clock advances.
+ */
+class Line {
+public:
+  Line(Clock& clock, const uint32_t& rate);
+
+  void send(const uint8_t* data, const size_t& count);
+  /* Bytes arrived by now */
+  size_t available() const;
+  size_t read(uint8_t* data, const size_t& count);
+
+  /*
+   * Arrival time of the last byte read, of the next byte to read and of
+   * the last byte sent
+   */
+  uint64_t last() const;
+  uint64_t next() const;
+  uint64_t idle() const;
+
+  Clock& clock() const;
+  const Timing& timing() const;
+
+  uint64_t Sent;
+  uint64_t Received;
+
+private:
+  struct Burst {
+    uint64_t start;
+    size_t count;
+  };
+
+  /* Arrival time of the byte at index of the front burst */
+  uint64_t arrival(const Burst& burst, const size_t& index) const;
+
+  Clock& clock_;
+  Timing timing_;
+  WordQueue bytes_;
+  std::deque<Burst> bursts_;
+  uint64_t last_;
+  uint64_t idle_;
+};
+
+}
+}
+}
+}
+}
+
+#endif
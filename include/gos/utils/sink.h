@@ -0,0 +1,82 @@
+#ifndef _GOS_ARDUINO_TESTING_UTILS_SINK_H_
+#define _GOS_ARDUINO_TESTING_UTILS_SINK_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <string>
+#include <vector>
+
+#define GOS_ARDUINO_TESTING_SINK_CAPACITY 256
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace utils {
+
+/* Destination for the bytes a Print writes, a whole span per call */
+class Sink {
+public:
+  virtual ~Sink() {}
+
+  /* Returns the number of bytes taken */
+  virtual size_t write(const uint8_t* data, const size_t& size) = 0;
+};
+
+/* Keeps everything written in one growable contiguous buffer */
+class BufferSink : public Sink {
+public:
+  BufferSink(const size_t& capacity = GOS_ARDUINO_TESTING_SINK_CAPACITY);
+
+  size_t write(const uint8_t* data, const size_t& size) override;
+
+  const uint8_t* data() const;
+  size_t size() const;
+  std::string str() const;
+  void clear();
+
+private:
+  std::vector<uint8_t> buffer_;
+};
+
+/*
+ * Keeps the last capacity bytes written, older bytes are overwritten so
+ * a soak test holds the tail of its log in constant memory.
+ */
+class RingSink : public Sink {
+public:
+  RingSink(const size_t& capacity = GOS_ARDUINO_TESTING_SINK_CAPACITY);
+
+  size_t write(const uint8_t* data, const size_t& size) override;
+
+  size_t size() const;
+  size_t capacity() const;
+  /* The kept bytes, oldest first */
+  std::string str() const;
+  void clear();
+
+  uint64_t Overwritten;
+
+private:
+  std::vector<uint8_t> buffer_;
+  size_t head_;
+  size_t count_;
+};
+
+/* Hands every span straight to a file descriptor, stdout by default */
+class DescriptorSink : public Sink {
+public:
+  DescriptorSink(const int& descriptor = 1);
+
+  size_t write(const uint8_t* data, const size_t& size) override;
+
+private:
+  int descriptor_;
+};
+
+}
+}
+}
+}
+
+#endif
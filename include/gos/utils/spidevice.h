@@ -0,0 +1,136 @@
+#ifndef _GOS_ARDUINO_TESTING_UTILS_SPI_DEVICE_H_
+#define _GOS_ARDUINO_TESTING_UTILS_SPI_DEVICE_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include <gos/utils/order.h>
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace utils {
+namespace spi {
+
+/*
+ * Model of a SPI slave. The SPI mock forwards every byte clocked while
+ * the device chip select is low and the device computes the MISO byte
+ * from the MOSI byte, so no response has to be queued up front.
+ */
+class Device {
+public:
+  Device(
+    const bit::Order& order = bit::Order::MsbFirst,
+    const uint8_t& modes = 0x01);
+  virtual ~Device();
+
+  /* Chip select went low */
+  virtual void select();
+  /* Chip select went high */
+  virtual void deselect();
+
+  virtual uint8_t transfer(const uint8_t& mosi) = 0;
+  virtual void transfer(uint8_t* buffer, const size_t& count);
+
+  /* Bit order the device shifts data in and out with */
+  bit::Order BitOrder;
+  /* Supported SPI modes as a mask, bit n set when mode n is supported */
+  uint8_t Modes;
+};
+
+/*
+ * MAX31865 RTD to digital converter register model. The first byte after
+ * select is the register address, bit 7 set for write, and the address
+ * increments for each following byte.
+ */
+class Max31865 : public Device {
+public:
+  enum {
+    Configuration = 0x00,
+    RtdMsb = 0x01,
+    RtdLsb = 0x02,
+    HighFaultMsb = 0x03,
+    HighFaultLsb = 0x04,
+    LowFaultMsb = 0x05,
+    LowFaultLsb = 0x06,
+    FaultStatus = 0x07,
+    RegisterCount = 0x08
+  };
+
+  Max31865();
+
+  /* Set the 15-bit RTD ADC code and the fault bit of the RTD LSB */
+  void rtd(const uint16_t& raw, const bool& fault = false);
+  void fault(const uint8_t& status);
+
+  void select();
+  uint8_t transfer(const uint8_t& mosi);
+
+  uint8_t Registers[RegisterCount];
+
+private:
+  bool addressed_;
+  bool write_;
+  uint8_t address_;
+};
+
+/*
+ * MAX6675 thermocouple to digital converter. Each selection shifts out
+ * one 16-bit frame: a dummy bit, 12-bit temperature in 0.25 C steps,
+ * the open thermocouple bit, device ID and state.
+ */
+class Max6675 : public Device {
+public:
+  Max6675();
+
+  void temperature(const double& celsius);
+  void open(const bool& open);
+
+  void select();
+  uint8_t transfer(const uint8_t& mosi);
+
+  uint16_t Frame;
+
+private:
+  uint16_t latched_;
+  uint8_t index_;
+};
+
+/*
+ * MCP3208 12-bit ADC modelled at bit level so any byte alignment of the
+ * start bit works. After the start bit come SGL/DIFF and D2..D0, one
+ * sample clock, a null bit and B11..B0 MSB first followed by B1..B11
+ * LSB first while chip select stays low.
+ */
+class Mcp3208 : public Device {
+public:
+  enum {
+    ChannelCount = 8
+  };
+
+  Mcp3208();
+
+  void select();
+  uint8_t transfer(const uint8_t& mosi);
+
+  /* Conversion result for single ended channels */
+  uint16_t Single[ChannelCount];
+  /* Conversion result for the differential configuration D2..D0 */
+  uint16_t Differential[ChannelCount];
+
+private:
+  uint8_t shift(const uint8_t& mosi);
+
+  uint8_t state_;
+  uint8_t configuration_;
+  uint8_t count_;
+  uint16_t value_;
+};
+
+}
+}
+}
+}
+}
+
+#endif
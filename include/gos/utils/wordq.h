@@ -1,22 +1,42 @@
 #ifndef _GOS_ARDUINO_TESTING_UTILS_WORD_QUEUE_H_
 #define _GOS_ARDUINO_TESTING_UTILS_WORD_QUEUE_H_
 
+#include <cstddef>
 #include <cstdint>
-#include <queue>
+
+#include <memory>
 
 #include <gos/utils/order.h>
 
+#define GOS_ARDUINO_TESTING_WORD_QUEUE_CAPACITY 64
+
 namespace gos {
 namespace arduino {
 namespace testing {
 namespace utils {
 
+/* A contiguous view into bytes owned by someone else */
+struct Span {
+  const uint8_t* data;
+  size_t size;
+};
+
+/*
+ * FIFO of bytes backed by a growable ring buffer. The capacity is always
+ * a power of two so positions wrap with a mask, and bulk operations move
+ * at most two contiguous segments with memcpy.
+ */
 class WordQueue {
 public:
-  WordQueue(const byte::Order& order = byte::Order::BigEndian);
+  WordQueue(
+    const byte::Order& order = byte::Order::BigEndian,
+    const size_t& capacity = GOS_ARDUINO_TESTING_WORD_QUEUE_CAPACITY);
 
-  size_t bytes();
-  size_t words();
+  size_t bytes() const;
+  size_t words() const;
+  size_t capacity() const;
+  /* Byte order of the words pushed and popped */
+  byte::Order order() const;
 
   void pushbyte(const uint8_t& byte);
   void pushbytes(const uint8_t* data, const size_t& count);
@@ -25,12 +45,48 @@ public:
 
   bool popbyte(uint8_t& value);
   bool popword(uint16_t& value);
+  size_t popbytes(uint8_t* data, const size_t& count);
+  size_t popwords(uint16_t* words, const size_t& count);
+
+  /* Discard up to count bytes from the front, returns the number dropped */
+  size_t drop(const size_t& count);
 
+  /*
+   * View the queued bytes without draining them. The ring is rotated in
+   * place when the content wraps so the view is always a single span.
+   * The view is invalidated by any following push.
+   */
+  Span peek();
+
+  /*
+   * View the queued bytes as the two segments of the ring, second is
+   * empty unless the content wraps. Nothing is moved, the views are
+   * invalidated by any following push.
+   */
+  void peek(Span& first, Span& second) const;
+
+  /*
+   * Contiguous space for count bytes at the back of the queue so a
+   * producer can write in place, commit makes the first count of them
+   * part of the queue. The space is invalidated by any other push.
+   */
+  uint8_t* prepare(const size_t& count);
+  void commit(const size_t& count);
+
+  void reserve(const size_t& capacity);
   void clear();
 
 private:
-  typedef std::queue<uint8_t> ByteQueue;
-  ByteQueue queue_;
+  typedef std::unique_ptr<uint8_t[]> Buffer;
+
+  size_t tail() const;
+  void ensure(const size_t& count);
+  void linearize();
+
+  Buffer buffer_;
+  size_t capacity_;
+  size_t head_;
+  size_t count_;
   byte::Order order_;
 };
 
@@ -1,14 +1,27 @@
-#ifndef MODBUSSLAVE_H
-#define MODBUSSLAVE_H
+#ifndef _GOS_ARDUINO_MOCK_MODBUS_SLAVE_H_
+#define _GOS_ARDUINO_MOCK_MODBUS_SLAVE_H_
 
 #include <memory>
 
 #include <Arduino.h>
 
+#include <gos/utils/bits.h>
+#include <gos/utils/registers.h>
+#include <gos/utils/rtu.h>
+#include <gos/utils/wordq.h>
+
 #define MODBUS_MAX_BUFFER 256
 #define MODBUS_INVALID_UNIT_ADDRESS 255
 #define MODBUS_DEFAULT_UNIT_ADDRESS 1
 #define MODBUS_CONTROL_PIN_NONE -1
+#define MODBUS_BROADCAST_ADDRESS 0
+#define MODBUS_TCP_UNIT_ADDRESS 255
+#define MODBUS_TCP_HEADER_SIZE 7
+#define MODBUS_TCP_MAX_ADU 260
+
+namespace gos {
+namespace arduino {
+namespace mock {
 
 /**
  * Modbus function codes
@@ -59,8 +72,21 @@ enum {
 
 typedef uint8_t(*MobbusCallback)(uint8_t, uint16_t, uint16_t);
 
+typedef ::gos::arduino::testing::utils::WordQueue WordQueue;
+typedef ::gos::arduino::testing::utils::Span Span;
+typedef ::gos::arduino::testing::utils::rtu::Line Line;
+typedef ::gos::arduino::testing::utils::word::Order WordOrder;
+
 /**
  * @class Modbus
+ *
+ * RTU slave simulator. poll() assembles a request frame from the stream,
+ * checks the unit address and the CRC, dispatches to cbVector and writes
+ * the response or an exception response back to the stream. The coil,
+ * discrete and register maps are the slave data, the callbacks run
+ * before a read is answered and after a write is stored, and the buffer
+ * access offsets index the maps directly. It lives in a namespace so it
+ * links next to the ArduinoModbusSlave library it stands in for.
  */
 class Modbus {
 public:
@@ -94,6 +120,14 @@ public:
   void begin(uint64_t boudRate);
   void setUnitAddress(uint8_t unitAddress);
   uint8_t poll();
+  uint8_t poll(WordQueue& receive, WordQueue& transmit);
+  uint8_t poll(Line& receive, Line& transmit);
+  /*
+   * Modbus TCP on a connection byte stream. Answers every complete MBAP
+   * framed request queued, so a master can pipeline transactions, and
+   * returns the number answered.
+   */
+  size_t serve(WordQueue& receive, WordQueue& transmit);
 
   bool readCoilFromBuffer(int offset);
   uint16_t readRegisterFromBuffer(int offset);
@@ -111,8 +145,18 @@ public:
   uint64_t getTotalBytesReceived();
 
   MobbusCallback cbVector[CB_MAX];
+
+  /* Processed requests, exception responses and discarded frames */
+  uint64_t Requests;
+  uint64_t Exceptions;
+  uint64_t Discarded;
+  /* Host nanoseconds spent handling requests */
+  uint64_t Busy;
+  /* Advance the virtual clock by the host time spent before replying */
+  bool Charge;
   
-  typedef std::unique_ptr<bool[]> BitBuffer;
+  /* Coils and discretes packed 64 to a word */
+  typedef ::gos::arduino::testing::utils::Bits BitBuffer;
   typedef std::unique_ptr<uint16_t[]> RegisterBuffer;
 
   size_t CoilCount;
@@ -128,17 +172,112 @@ public:
   void createregisters(const size_t& registercount);
   void createpattern(const Pattern& pattern);
 
+  /*
+   * Typed access to contiguous registers from address, count values of
+   * Width<T> registers each in one call
+   */
+  template<typename T>
+  uint8_t setregisters(
+    const size_t& address,
+    const T* values,
+    const size_t& count,
+    const WordOrder& order = WordOrder::LowFirst) {
+    namespace gatur = ::gos::arduino::testing::utils::registers;
+    if (address + count * gatur::Width<T>::value > RegisterCount) {
+      return STATUS_ILLEGAL_DATA_ADDRESS;
+    }
+    gatur::put(Registers.get() + address, values, count, order);
+    return STATUS_OK;
+  }
+
   template<typename T>
-  void setregisters(const size_t& address, T& value) {
-    uint16_t regvalue;
-    size_t registerscount = sizeof(T) > 2 ? sizeof(T) / 2 : 1;
-    char* pointer = reinterpret_cast<char*>(&value);
-    for (size_t r = 0; r < registerscount; r++) {
-      ::memcpy((void*)(&regvalue), pointer, 2);
-      Registers[r] = regvalue;
-      pointer += 2;
+  uint8_t getregisters(
+    const size_t& address,
+    T* values,
+    const size_t& count,
+    const WordOrder& order = WordOrder::LowFirst) const {
+    namespace gatur = ::gos::arduino::testing::utils::registers;
+    if (address + count * gatur::Width<T>::value > RegisterCount) {
+      return STATUS_ILLEGAL_DATA_ADDRESS;
     }
+    gatur::get(values, Registers.get() + address, count, order);
+    return STATUS_OK;
+  }
+
+  template<typename T>
+  uint8_t setregisters(
+    const size_t& address,
+    const T& value,
+    const WordOrder& order = WordOrder::LowFirst) {
+    return setregisters(address, &value, 1, order);
   }
+
+private:
+  void initialize(uint8_t unitAddress, int transmissionControlPin);
+
+  /* Request length from the header received so far, 0 when unknown */
+  size_t expected(const uint8_t* frame, const size_t& length) const;
+  /*
+   * Length of a request of a function without a known layout, the
+   * shortest frame of at least 4 bytes whose CRC checks, 0 while no CRC
+   * checks yet.
+   */
+  size_t delimit(const Span& first, const Span& second) const;
+  /* Take the frame at the front of receive, returns the reply length */
+  size_t take(WordQueue& receive, uint8_t* reply);
+  /*
+   * Handle a complete frame held in up to two segments, the second one
+   * continues the first where a ring wraps. Returns the reply length.
+   */
+  size_t process(const Span& first, const Span& second, uint8_t* reply);
+  /* Handle a complete ADU, returns the length of the reply ADU built */
+  size_t respond(const Span& first, const Span& second, uint8_t* reply);
+  uint8_t dispatch();
+  uint8_t callback(uint8_t index, uint16_t address, uint16_t length);
+  uint8_t exception(uint8_t status);
+  void seal();
+  uint8_t transmit(const size_t& length);
+
+  /* The CRC closing the frame matches the bytes before it */
+  bool valid() const;
+  uint8_t at(const size_t& index) const;
+  uint16_t word(const size_t& index) const;
+  void append(const uint8_t& byte);
+  void appendword(const uint16_t& word);
+  /* A register block in one pass, big endian */
+  void appendwords(const uint16_t* words, const size_t& count);
+
+  Stream* serial_;
+  uint8_t unitAddress_;
+  int transmissionControlPin_;
+  uint8_t exceptionStatus_;
+
+  /* Bytes read from the stream and not yet taken as a frame */
+  WordQueue pending_;
+  /* What is left to drop of a frame too long for the buffer */
+  size_t skip_;
+
+  /* Frame assembly of the line transport */
+  uint8_t request_[MODBUS_MAX_BUFFER];
+  size_t requestLength_;
+  /* Response of the stream and line transports */
+  uint8_t response_[MODBUS_MAX_BUFFER];
+  /* A t1.5 gap or an overrun broke the frame being assembled */
+  bool corrupt_;
+
+  /* Request being handled and the reply being built, in place */
+  Span frame_;
+  Span wrap_;
+  size_t frameLength_;
+  uint8_t* reply_;
+  size_t responseLength_;
+
+  uint64_t totalBytesSent_;
+  uint64_t totalBytesReceived_;
 };
 
+}
+}
+}
+
 #endif
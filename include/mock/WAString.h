@@ -8,6 +8,9 @@
 
 #include <Arduino.h>
 
+#include <gos/utils/heap.h>
+#include <gos/utils/sink.h>
+
 #define DEC 10
 #define HEX 16
 #define OCT 8
@@ -16,6 +19,9 @@
 #endif
 #define BIN 2
 
+/* Characters a String holds before it allocates, terminator included */
+#define STRING_INLINE_SIZE 32
+
 class String;
 
 namespace gos {
@@ -23,21 +29,30 @@ namespace arduino {
 namespace mock {
 class Print
 {
+public:
+  typedef ::gos::arduino::testing::utils::Sink Sink;
+  typedef ::gos::arduino::testing::utils::BufferSink BufferSink;
+
 private:
   int write_error;
-  size_t printNumber(unsigned long, uint8_t);
+  Sink* sink_;
+  BufferSink buffer_;
+  size_t printNumber(unsigned long, uint8_t, bool = false);
   size_t printFloat(double, uint8_t);
 protected:
   void setWriteError(int err = 1) { write_error = err; }
 public:
-  std::stringstream s_;
-
-  Print() : write_error(0) {}
+  // Without a sink everything printed is kept in buffer()
+  Print(Sink* sink = nullptr) : write_error(0), sink_(sink) {}
 
   int getWriteError() { return write_error; }
   void clearWriteError() { setWriteError(0); }
 
-  virtual size_t write(uint8_t) = 0;
+  void sink(Sink* sink) { sink_ = sink; }
+  Sink* sink() const { return sink_; }
+  BufferSink& buffer() { return buffer_; }
+
+  virtual size_t write(uint8_t c) { return write(&c, 1); }
   size_t write(const char* str) {
     if (str == nullptr) return 0;
     return write((const uint8_t*)str, strlen(str));
@@ -80,10 +95,12 @@ public:
 }
 
 class String {
-  std::string s_;
 public:
+  typedef ::gos::arduino::testing::utils::Heap Heap;
+
   String(const char* cstr = "");
   String(const String& str);
+  String(String&& rval);
 
   explicit String(char c);
   explicit String(unsigned char, unsigned char base = 10);
@@ -100,13 +117,20 @@ public:
 // is left unchanged).  reserve(0), if successful, will validate an
 // invalid string (i.e., "if (s)" will be true afterwards)
   unsigned char reserve(unsigned int size);
-  inline unsigned int length(void) const { return (unsigned int)(s_.length()); }
+  inline unsigned int length(void) const { return len_; }
+
+  // Strings created from now on allocate from heap the way a device does,
+  // every buffer sized exactly and no inline buffer. nullptr goes back to
+  // the host heap.
+  static void arena(Heap* heap);
+  static Heap* arena();
 
   // creates a copy of the assigned value.  if the value is null or
   // invalid, or if the memory allocation fails, the string will be
   // marked as invalid ("if (s)" will be false).
   String& operator = (const String& rhs);
   String& operator = (const char* cstr);
+  String& operator = (String&& rval);
 
   // concatenate (works w/ built-in types)
 
@@ -165,7 +189,7 @@ public:
   {
     getBytes((unsigned char*)buf, bufsize, index);
   }
-  const char* c_str() const { return s_.c_str(); }
+  const char* c_str() const { return buffer_ ? buffer_ : ""; }
   //char* begin() { return buffer; }
   //char* end() { return buffer + length(); }
   const char* begin() const { return c_str(); }
@@ -180,7 +204,7 @@ public:
   int lastIndexOf(char ch, unsigned int fromIndex) const;
   int lastIndexOf(const String& str) const;
   int lastIndexOf(const String& str, unsigned int fromIndex) const;
-  String substring(unsigned int beginIndex) const { return substring(beginIndex, s_.length()); };
+  String substring(unsigned int beginIndex) const { return substring(beginIndex, len_); };
   String substring(unsigned int beginIndex, unsigned int endIndex) const;
 
   // modification
@@ -197,6 +221,22 @@ public:
   float toFloat(void) const;
   double toDouble(void) const;
 
+private:
+  void init(void);
+  void invalidate(void);
+  void release(void);
+  unsigned char changeBuffer(unsigned int maxStrLen);
+  String& copy(const char* cstr, unsigned int length);
+  void move(String& rhs);
+  unsigned char concat(const char* cstr, unsigned int length);
+
+  char* buffer_;
+  unsigned int capacity_;  // the array length minus one (for the '\0')
+  unsigned int len_;       // the String length (not counting the '\0')
+  Heap* heap_;
+  char inline_[STRING_INLINE_SIZE];
+
+  static Heap* arena_;
 };
 
 #endif
\ No newline at end of file
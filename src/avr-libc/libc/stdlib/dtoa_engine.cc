@@ -0,0 +1,180 @@
+#include <dtoa_engine.h>
+#include <ftoa_engine.h>
+
+#include <stdio.h>
+#include <string.h>
+
+static const uint64_t powerTable[20] = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+    1000000000000000000ULL,
+    10000000000000000000ULL
+};
+
+static const char digitPairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/* Full 128 bit product of two 64 bit values */
+static void multiply(uint64_t a, uint64_t b, uint64_t *hi, uint64_t *lo)
+{
+  uint64_t al = a & 0xffffffffULL, ah = a >> 32;
+  uint64_t bl = b & 0xffffffffULL, bh = b >> 32;
+  uint64_t ll = al * bl, lh = al * bh, hl = ah * bl, hh = ah * bh;
+  uint64_t middle = (ll >> 32) + (lh & 0xffffffffULL) + (hl & 0xffffffffULL);
+  *lo = (middle << 32) | (ll & 0xffffffffULL);
+  *hi = hh + (lh >> 32) + (hl >> 32) + (middle >> 32);
+}
+
+/*
+ * round(m * 10^prec * 2^e) to nearest even in *scaled. Returns 0 when
+ * the result does not fit in 64 bits.
+ */
+static uint8_t dtoa_scale(uint64_t m, int16_t e, uint8_t prec,
+  uint64_t *scaled)
+{
+  uint64_t hi, lo;
+  multiply(m, powerTable[prec], &hi, &lo);
+
+  if (e >= 0) {
+    if (hi != 0 || e >= 64 || (lo >> (63 - e)) > 1) return 0;
+    *scaled = lo << e;
+    return 1;
+  }
+
+  uint16_t shift = -e;
+  // The product is below 2^117, far enough right it rounds to zero.
+  if (shift >= 118) {
+    *scaled = 0;
+    return 1;
+  }
+
+  uint64_t q, rhi, rlo, halfhi, halflo;
+  if (shift < 64) {
+    if ((hi >> shift) != 0) return 0;
+    q = (hi << (64 - shift)) | (lo >> shift);
+    rhi = 0;
+    rlo = lo & ((1ULL << shift) - 1);
+    halfhi = 0;
+    halflo = 1ULL << (shift - 1);
+  }
+  else {
+    q = shift == 64 ? hi : hi >> (shift - 64);
+    rhi = shift == 64 ? 0 : hi & ((1ULL << (shift - 64)) - 1);
+    rlo = lo;
+    halfhi = shift == 64 ? 0 : 1ULL << (shift - 65);
+    halflo = shift == 64 ? 1ULL << 63 : 0;
+  }
+
+  if (rhi > halfhi || (rhi == halfhi && rlo > halflo) ||
+    (rhi == halfhi && rlo == halflo && (q & 1))) {
+    if (++q == 0) return 0;
+  }
+  *scaled = q;
+  return 1;
+}
+
+/* Decimal digits of value right aligned to end, returns the count */
+static uint8_t dtoa_digits(uint64_t value, char *end)
+{
+  uint8_t count = 0;
+  while (value >= 100) {
+    const char *pair = digitPairs + 2 * (value % 100);
+    value /= 100;
+    *--end = pair[1];
+    *--end = pair[0];
+    count += 2;
+  }
+  if (value >= 10) {
+    *--end = digitPairs[2 * value + 1];
+    *--end = digitPairs[2 * value];
+    return count + 2;
+  }
+  *--end = '0' + (char)value;
+  return count + 1;
+}
+
+int16_t dtoa_engine(double val, char *buf, uint8_t prec)
+{
+  uint64_t bits;
+  memcpy(&bits, &val, sizeof(bits));
+
+  uint8_t flags = (bits >> 63) ? FTOA_MINUS : 0;
+  uint16_t exponent = (bits >> 52) & 0x7ff;
+  uint64_t m = bits & 0x000fffffffffffffULL;
+
+  if (exponent == 0x7ff) {
+    buf[0] = flags | (m == 0 ? FTOA_INF : FTOA_NAN);
+    buf[1] = 0;
+    return 0;
+  }
+  if (exponent == 0 && m == 0) flags |= FTOA_ZERO;
+
+  int16_t e;
+  if (exponent == 0) {
+    e = -1074;
+  }
+  else {
+    m |= 1ULL << 52;
+    e = exponent - 1075;
+  }
+
+  uint64_t scaled;
+  if (prec >= 20 || !dtoa_scale(m, e, prec, &scaled)) {
+    // Too wide for 64 bits, the C library is exact as well.
+    int16_t length = (int16_t)snprintf(buf + 1, DTOA_ENGINE_BUFFER - 1,
+      "%.*f", prec, (flags & FTOA_MINUS) ? -val : val);
+    buf[0] = flags;
+    return length;
+  }
+
+  // Integer digits then the decimals, at least one digit before the point.
+  char digits[21];
+  uint8_t count = dtoa_digits(scaled, digits + sizeof(digits));
+  const char *first = digits + sizeof(digits) - count;
+  char *s = buf + 1;
+  if (count > prec) {
+    memcpy(s, first, count - prec);
+    s += count - prec;
+    first += count - prec;
+    count = prec;
+  }
+  else {
+    *s++ = '0';
+  }
+  if (prec) {
+    *s++ = '.';
+    memset(s, '0', prec - count);
+    s += prec - count;
+    memcpy(s, first, count);
+    s += count;
+  }
+  *s = 0;
+
+  buf[0] = flags;
+  return (int16_t)(s - buf - 1);
+}
@@ -28,14 +28,68 @@
 
 /* $Id$ */
 
+#include <string.h>
+
 #include <ftoa_engine.h>
+#include <dtoa_engine.h>
 #include <dtoa_conv.h>
 //#include "sectionname.h"
 
 int
 dtoa_prf(double val, char *s, unsigned char width, unsigned char prec,
   unsigned char flags) {
+#ifdef DTOA_PRF_DOUBLE
+  return dtoa_prf_d(val, s, width, prec, flags);
+#else
   return dtoa_prf_f(static_cast<float>(val), s, width, prec, flags);
+#endif
+}
+
+/* The layout of dtoa_prf_f around the digits of dtoa_engine */
+int
+dtoa_prf_d(double val, char *s, unsigned char width, unsigned char prec,
+  unsigned char flags) {
+  char buf[DTOA_ENGINE_BUFFER];
+  int n = dtoa_engine(val, buf, prec);
+  unsigned char vtype = buf[0];
+  unsigned char sign = 0;
+  if ((vtype & (FTOA_MINUS | FTOA_NAN)) == FTOA_MINUS)
+    sign = '-';
+  else if (flags & DTOA_PLUS)
+    sign = '+';
+  else if (flags & DTOA_SPACE)
+    sign = ' ';
+
+  const char *text = buf + 1;
+  if (vtype & (FTOA_NAN | FTOA_INF)) {
+    if (vtype & FTOA_NAN)
+      text = flags & DTOA_UPPER ? "NAN" : "nan";
+    else
+      text = flags & DTOA_UPPER ? "INF" : "inf";
+    n = 3;
+    flags &= ~DTOA_ZFILL;
+  }
+
+  int length = n + (sign ? 1 : 0);
+  int fill = width > length ? width - length : 0;
+  if (!(flags & DTOA_LEFT) && !(flags & DTOA_ZFILL)) {
+    memset(s, ' ', fill);
+    s += fill;
+    fill = 0;
+  }
+  if (sign) *s++ = sign;
+  if (!(flags & DTOA_LEFT)) {
+    memset(s, '0', fill);
+    s += fill;
+    fill = 0;
+  }
+  memcpy(s, text, n);
+  s += n;
+  memset(s, ' ', fill);
+  s += fill;
+  *s = 0;
+
+  return vtype & (FTOA_NAN | FTOA_INF) ? DTOA_NONFINITE : 0;
 }
 
 int
@@ -130,8 +184,8 @@ dtoa_prf_f (float val, char *s, unsigned char width, unsigned char prec,
 	ndigs -= 1;
     if ((signed char)ndigs < 1)
 	ndigs = 1;
-    else if (ndigs > 8)
-	ndigs = 8;
+    else if (ndigs > 7)
+	ndigs = 7;		/* the engine writes 7 digits, not 8	*/
 
     n = exp > 0 ? exp : 0;
     do {
@@ -78,7 +78,43 @@ static const uint32_t factorTable[32] = {
     1038459372UL
 };
 
-int16_t ftoa_engine(float val, char *buf, uint8_t precision, uint8_t maxDecimals)
+static const int64_t powerTable[16] = {
+    1LL,
+    10LL,
+    100LL,
+    1000LL,
+    10000LL,
+    100000LL,
+    1000000LL,
+    10000000LL,
+    100000000LL,
+    1000000000LL,
+    10000000000LL,
+    100000000000LL,
+    1000000000000LL,
+    10000000000000LL,
+    100000000000000LL,
+    1000000000000000LL
+};
+
+static const char digitPairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/*
+ * Scale val to a 64 bit fixed point decimal. Returns 0 when buf already
+ * holds the result, the value zero.
+ */
+static uint8_t ftoa_scale(float val, char *buf, uint8_t precision,
+  uint8_t *flagsp, int8_t *exp10p, int64_t *prodp)
 {
   uint8_t flags;
 
@@ -91,8 +127,6 @@ int16_t ftoa_engine(float val, char *buf, uint8_t precision, uint8_t maxDecimals
   x.v = val;
   uint32_t frac = x.u & 0x007fffffUL;
 
-  if (precision > 7) precision = 7;
-
   // Read the sign, shift the exponent in place and delete it from frac.
   if (valbits[3] & (1 << 7)) flags = FTOA_MINUS; else flags = 0;
   uint8_t exp = valbits[3] << 1;
@@ -131,6 +165,19 @@ int16_t ftoa_engine(float val, char *buf, uint8_t precision, uint8_t maxDecimals
   // If the lower 3 bits are 0 we right-shift 7x
   prod >>= (15 - (exp & 7));
 
+  *flagsp = flags;
+  *exp10p = exp10;
+  *prodp = prod;
+  return 1;
+}
+
+/*
+ * The digit loop as written for the AVR, one subtraction per unit of
+ * every digit.
+ */
+static int16_t ftoa_subtract(char *buf, uint8_t precision, uint8_t maxDecimals,
+  uint8_t flags, int8_t exp10, int64_t prod)
+{
   // Now convert to decimal.
   uint8_t hadNonzeroDigit = 0; // a flag
   uint8_t outputIdx = 0;
@@ -221,3 +268,87 @@ int16_t ftoa_engine(float val, char *buf, uint8_t precision, uint8_t maxDecimals
   buf[0] = flags;
   return exp10;
 }
+
+/*
+ * The same digits by division. The leading digit is found against the
+ * power table, the digits to output are taken in one division, rounded
+ * as the loop rounds and written two at a time. Returns 0 when the value
+ * is outside what the loop handles regularly and it has to run instead.
+ */
+static uint8_t ftoa_divide(char *buf, uint8_t precision, uint8_t maxDecimals,
+  uint8_t flags, int8_t exp10, int64_t prod, int16_t *result)
+{
+  // A first digit above 9 is the abnormal case of the loop.
+  if (prod <= 0 || prod >= powerTable[15]) return 0;
+
+  int8_t k = 14;
+  while (prod < powerTable[k]) k--;
+  exp10 -= 14 - k;
+
+  if (maxDecimals != 0) {
+    int8_t beforeDP = exp10 + 1;
+    if (beforeDP < 1) beforeDP = 1;
+    maxDecimals = maxDecimals + beforeDP - 1;
+    if (precision > maxDecimals)
+      precision = maxDecimals;
+  }
+  else {
+    precision++;
+  }
+
+  // With no digits asked for the loop still emits one, leave it to that.
+  if (precision == 0) return 0;
+
+  // The loop rounds up unconditionally once it runs out of places.
+  int8_t last = k - precision + 1;
+  if (last < 1) return 0;
+
+  int64_t divisor = powerTable[last];
+  uint32_t digits = (uint32_t)(prod / divisor);
+  if (prod - (int64_t)digits * divisor - (divisor >> 1) >= 0) {
+    if (++digits == (uint32_t)powerTable[precision]) {
+      digits = (uint32_t)powerTable[precision - 1];
+      exp10++;
+      flags |= FTOA_CARRY;
+    }
+  }
+
+  uint8_t outputIdx = precision;
+  while (outputIdx > 1) {
+    const char *pair = digitPairs + 2 * (digits % 100);
+    digits /= 100;
+    buf[outputIdx--] = pair[1];
+    buf[outputIdx--] = pair[0];
+  }
+  if (outputIdx == 1) buf[1] = '0' + digits;
+
+  buf[0] = flags;
+  *result = exp10;
+  return 1;
+}
+
+int16_t ftoa_engine(float val, char *buf, uint8_t precision, uint8_t maxDecimals)
+{
+  uint8_t flags;
+  int8_t exp10;
+  int64_t prod;
+  int16_t result;
+
+  if (precision > 7) precision = 7;
+  if (!ftoa_scale(val, buf, precision, &flags, &exp10, &prod)) return 0;
+  if (ftoa_divide(buf, precision, maxDecimals, flags, exp10, prod, &result))
+    return result;
+  return ftoa_subtract(buf, precision, maxDecimals, flags, exp10, prod);
+}
+
+int16_t ftoa_engine_reference(float val, char *buf, uint8_t precision,
+  uint8_t maxDecimals)
+{
+  uint8_t flags;
+  int8_t exp10;
+  int64_t prod;
+
+  if (precision > 7) precision = 7;
+  if (!ftoa_scale(val, buf, precision, &flags, &exp10, &prod)) return 0;
+  return ftoa_subtract(buf, precision, maxDecimals, flags, exp10, prod);
+}
@@ -1,3 +1,8 @@
+#include <cstring>
+
+#include <algorithm>
+#include <chrono>
+
 #include <gtest/gtest.h>
 
 #include <ModbusSlave.h>
@@ -6,25 +11,121 @@
 #include <FixedPointsCommon.h>
 #include <FixedPoints/SFixed.h>
 
-#include <gatlutility.h>
+#include <gos/utils/crc.h>
+#include <gos/utils/order.h>
+
+namespace gatuc = ::gos::arduino::testing::utils::crc;
+namespace gatuo = ::gos::arduino::testing::utils::byte;
 
-namespace gatl = ::gos::atl;
+#define MODBUS_MAX_READ_BITS 2000
+#define MODBUS_MAX_READ_REGISTERS 125
+#define MODBUS_MAX_WRITE_BITS 1968
+#define MODBUS_MAX_WRITE_REGISTERS 123
+/* Unit up to the byte count of a write multiple */
+#define MODBUS_RTU_HEADER_SIZE 7
+
+namespace gos {
+namespace arduino {
+namespace mock {
 
 typedef ::FixedPoints::SQ15x16 FixedPointType;
 
+typedef gatuc::Modbus<> Crc;
+
+static Span span(const uint8_t* data, const size_t& size) {
+  Span result;
+  result.data = data;
+  result.size = size;
+  return result;
+}
+
+/* The count bytes from offset on of a frame held in first and second */
+static void slice(
+  const Span& first,
+  const Span& second,
+  const size_t& offset,
+  const size_t& count,
+  Span& head,
+  Span& tail) {
+  if (offset < first.size) {
+    head = span(first.data + offset, std::min(count, first.size - offset));
+    tail = span(second.data, count - head.size);
+  } else {
+    head = span(second.data + offset - first.size, count);
+    tail = span(second.data, 0);
+  }
+}
+
+/* Copy up to count bytes from the front of first and second */
+static void gather(
+  const Span& first,
+  const Span& second,
+  uint8_t* bytes,
+  const size_t& count) {
+  Span head, tail;
+  slice(first, second, 0,
+    std::min(count, first.size + second.size), head, tail);
+  ::memcpy(bytes, head.data, head.size);
+  ::memcpy(bytes + head.size, tail.data, tail.size);
+}
+
+/* The byte at index of a frame held in first and second */
+static uint8_t octet(
+  const Span& first,
+  const Span& second,
+  const size_t& index) {
+  return index < first.size ?
+    first.data[index] : second.data[index - first.size];
+}
+
+/* Functions whose request length follows from the header */
+static bool known(const uint8_t& function) {
+  switch (function) {
+  case FC_READ_COILS:
+  case FC_READ_DISCRETE_INPUT:
+  case FC_READ_HOLDING_REGISTERS:
+  case FC_READ_INPUT_REGISTERS:
+  case FC_WRITE_COIL:
+  case FC_WRITE_REGISTER:
+  case FC_READ_EXCEPTION_STATUS:
+  case FC_WRITE_MULTIPLE_COILS:
+  case FC_WRITE_MULTIPLE_REGISTERS:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/* Only writes may be broadcast, a read has no one to answer to */
+static bool broadcastable(const uint8_t& function) {
+  switch (function) {
+  case FC_WRITE_COIL:
+  case FC_WRITE_REGISTER:
+  case FC_WRITE_MULTIPLE_COILS:
+  case FC_WRITE_MULTIPLE_REGISTERS:
+    return true;
+  default:
+    return false;
+  }
+}
+
 Modbus::Modbus(uint8_t unitAddress, int transmissionControlPin) {
+  initialize(unitAddress, transmissionControlPin);
 }
 
 Modbus::Modbus(
   Stream& serialStream,
   uint8_t unitAddress,
   int transmissionControlPin) {
+  initialize(unitAddress, transmissionControlPin);
+  serial_ = &serialStream;
 }
 
 Modbus::Modbus(
   const size_t& coilcount,
   const size_t& holdingcount,
   const Pattern& pattern) {
+  initialize(MODBUS_DEFAULT_UNIT_ADDRESS, MODBUS_CONTROL_PIN_NONE);
   createcoils(coilcount);
   createregisters(holdingcount);
   createpattern(pattern);
@@ -34,18 +135,151 @@ Modbus::Modbus(
   const size_t& coilcount,
   const size_t& holdingcount,
   const size_t& discretecount) {
+  initialize(MODBUS_DEFAULT_UNIT_ADDRESS, MODBUS_CONTROL_PIN_NONE);
   createcoils(coilcount);
   createregisters(holdingcount);
   creatediscretes(discretecount);
 }
 
-void Modbus::begin(uint64_t boudRate) {}
-void Modbus::setUnitAddress(uint8_t unitAddress) {}
-uint8_t Modbus::poll() { return 0; }
+void Modbus::begin(uint64_t boudRate) {
+  if (transmissionControlPin_ > MODBUS_CONTROL_PIN_NONE) {
+    pinMode(transmissionControlPin_, OUTPUT);
+    digitalWrite(transmissionControlPin_, LOW);
+  }
+  requestLength_ = 0;
+  responseLength_ = 0;
+}
+
+void Modbus::setUnitAddress(uint8_t unitAddress) {
+  unitAddress_ = unitAddress;
+}
+
+/*
+ * Queues what the stream has available and answers at most one request
+ * frame. The frame length follows from the function code so back to back
+ * requests are split correctly. Returns the number of response bytes sent.
+ */
+uint8_t Modbus::poll() {
+  if (serial_ == nullptr) {
+    return 0;
+  }
+  int available = serial_->available();
+  if (available > 0) {
+    uint8_t* space = pending_.prepare(static_cast<size_t>(available));
+    pending_.commit(
+      serial_->readBytes(space, static_cast<size_t>(available)));
+  }
+  return transmit(take(pending_, response_));
+}
+
+/*
+ * Zero copy variant for a queue based transport. The request is parsed
+ * in place in the receive ring and the response is built directly at
+ * the back of the transmit ring. Returns the response length.
+ */
+uint8_t Modbus::poll(WordQueue& receive, WordQueue& transmit) {
+  uint8_t* reply = transmit.prepare(MODBUS_MAX_BUFFER);
+  size_t replied = take(receive, reply);
+  transmit.commit(replied);
+  totalBytesSent_ += replied;
+  return static_cast<uint8_t>(replied);
+}
+
+/*
+ * RTU framing in virtual time. Characters are collected while they
+ * arrive, a gap longer than t1.5 inside a frame marks it corrupt and the
+ * frame is complete once the line has been silent for t3.5. Returns the
+ * response length, the response is sent on the transmit line.
+ */
+uint8_t Modbus::poll(Line& receive, Line& transmit) {
+  const ::gos::arduino::testing::utils::rtu::Timing& timing =
+    receive.timing();
+  while (receive.available() > 0) {
+    if (requestLength_ > 0) {
+      uint64_t gap = receive.next() - receive.last() - timing.Character;
+      if (gap >= timing.Interframe) {
+        /* The next character starts a new frame */
+        break;
+      } else if (gap > timing.Interchar) {
+        corrupt_ = true;
+      }
+    }
+    uint8_t byte;
+    receive.read(&byte, 1);
+    totalBytesReceived_++;
+    if (requestLength_ < MODBUS_MAX_BUFFER) {
+      request_[requestLength_++] = byte;
+    } else {
+      corrupt_ = true;
+    }
+  }
+  if (requestLength_ == 0 ||
+    receive.clock().Now < receive.last() + timing.Interframe) {
+    return 0;
+  }
+  size_t replied = 0;
+  if (corrupt_) {
+    Discarded++;
+  } else {
+    std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+    replied = process(
+      span(request_, requestLength_), span(request_, 0), response_);
+    uint64_t elapsed = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    Busy += elapsed;
+    if (Charge) {
+      receive.clock().advance(elapsed / 1000);
+    }
+  }
+  requestLength_ = 0;
+  corrupt_ = false;
+  if (replied > 0) {
+    transmit.send(response_, replied);
+    totalBytesSent_ += replied;
+  }
+  return static_cast<uint8_t>(replied);
+}
+
+size_t Modbus::serve(WordQueue& receive, WordQueue& transmit) {
+  size_t served = 0;
+  for (;;) {
+    Span first, second;
+    receive.peek(first, second);
+    uint8_t header[MODBUS_TCP_HEADER_SIZE - 1];
+    if (first.size + second.size < sizeof(header)) {
+      break;
+    }
+    gather(first, second, header, sizeof(header));
+    size_t length = sizeof(header) +
+      (static_cast<size_t>(header[4]) << 8 | header[5]);
+    if (length > MODBUS_TCP_MAX_ADU) {
+      /* The stream is out of step, a connection would be dropped */
+      Discarded++;
+      receive.clear();
+      break;
+    } else if (first.size + second.size < length) {
+      break;
+    }
+    totalBytesReceived_ += length;
+    Span head, tail;
+    slice(first, second, 0, length, head, tail);
+    uint8_t* reply = transmit.prepare(MODBUS_TCP_MAX_ADU);
+    size_t replied = respond(head, tail, reply);
+    transmit.commit(replied);
+    receive.drop(length);
+    totalBytesSent_ += replied;
+    if (replied > 0) {
+      served++;
+    }
+  }
+  return served;
+}
 
 bool Modbus::readCoilFromBuffer(int offset) {
   EXPECT_TRUE(offset < CoilCount);
-  return Coils[offset];
+  return Coils.get(offset);
 }
 
 uint16_t Modbus::readRegisterFromBuffer(int offset) {
@@ -54,16 +288,26 @@ uint16_t Modbus::readRegisterFromBuffer(int offset) {
 }
 
 uint8_t Modbus::writeExceptionStatusToBuffer(int offset, bool status) {
+  if (offset < 0 || offset > 7) {
+    return STATUS_ILLEGAL_DATA_ADDRESS;
+  }
+  if (status) {
+    exceptionStatus_ |= static_cast<uint8_t>(1 << offset);
+  } else {
+    exceptionStatus_ &= static_cast<uint8_t>(~(1 << offset));
+  }
   return STATUS_OK;
 }
 
 uint8_t Modbus::writeCoilToBuffer(int offset, bool state) {
   EXPECT_TRUE(offset < CoilCount);
-  Coils[offset] = state;
+  Coils.set(offset, state);
   return STATUS_OK;
 }
 
 uint8_t Modbus::writeDiscreteInputToBuffer(int offset, bool state) {
+  EXPECT_TRUE(offset < DiscreteCount);
+  Discretes.set(offset, state);
   return STATUS_OK;
 }
 
@@ -79,39 +323,32 @@ uint8_t Modbus::writeStringToBuffer(int offset, uint8_t* str, uint8_t length) {
 
 
 uint8_t Modbus::readFunctionCode() {
-  return 0;
+  return frameLength_ > 1 ? at(1) : FC_INVALID;
 }
 uint8_t Modbus::readUnitAddress() {
-  return 0;
+  return frameLength_ > 0 ?
+    at(0) : static_cast<uint8_t>(MODBUS_INVALID_UNIT_ADDRESS);
 }
 bool Modbus::isBroadcast() {
-  return true;
+  return readUnitAddress() == MODBUS_BROADCAST_ADDRESS;
 }
 
 uint64_t Modbus::getTotalBytesSent() {
-  return 0;
+  return totalBytesSent_;
 }
 uint64_t Modbus::getTotalBytesReceived() {
-  return 0;
+  return totalBytesReceived_;
 }
 
 void Modbus::createcoils(const size_t& coilcount) {
   CoilCount = coilcount;
-  if (CoilCount > 0) {
-    Coils = std::make_unique<bool[]>(CoilCount);
-    for (size_t i = 0; i < CoilCount; i++) {
-      Coils[i] = false;
-    }
-  }
+  Coils.resize(CoilCount);
+  Coils.fill(false);
 }
 void Modbus::creatediscretes(const size_t& discretecount) {
   DiscreteCount = discretecount;
-  if (DiscreteCount > 0) {
-    Discretes = std::make_unique<bool[]>(DiscreteCount);
-    for (size_t i = 0; i < DiscreteCount; i++) {
-      Discretes[i] = false;
-    }
-  }
+  Discretes.resize(DiscreteCount);
+  Discretes.fill(false);
 }
 void Modbus::createregisters(const size_t& registercount) {
   RegisterCount = registercount;
@@ -127,10 +364,9 @@ void Modbus::createpattern(const Pattern& pattern) {
   switch (pattern) {
   case Pattern::TrueFalse:
   {
-    bool value = true;
-    for (size_t i = 0; i < CoilCount; i++) {
-      Coils[i] = value;
-      value = value ? false : true;
+    Coils.fill(false);
+    for (size_t i = 0; i < CoilCount; i += 2) {
+      Coils.set(i, true);
     }
     break;
   }
@@ -144,52 +380,420 @@ void Modbus::createpattern(const Pattern& pattern) {
   }
   case Pattern::FixedPoints:
   {
-    double doublecast, doublevalue;
-    size_t i = 0;
-    uint16_t word;
-    FixedPointType value;
+    double doublecast;
     size_t count = RegisterCount / 2;
+    std::unique_ptr<FixedPointType[]> values(new FixedPointType[count]);
     for (size_t n = 0; n < count; n++) {
       doublecast = static_cast<double>(n);
-      doublevalue = 0.01 + doublecast + doublecast / 10.0;
-      value = doublevalue;
-      word = gatl::utility::number::part::first<uint16_t>(value);
-      Registers[i++] = word;
-      word = gatl::utility::number::part::second<uint16_t>(value);
-      Registers[i++] = word;
+      values[n] = 0.01 + doublecast + doublecast / 10.0;
     }
+    setregisters(0, values.get(), count);
     break;
   }
   case Pattern::Floats:
   {
-    float floatcast, value;
-    size_t i = 0;
-    uint16_t word;
+    float floatcast;
     size_t count = RegisterCount / 2;
+    std::unique_ptr<float[]> values(new float[count]);
     for (size_t n = 0; n < count; n++) {
       floatcast = static_cast<float>(n);
-      value = 0.01F + floatcast + floatcast / 10.0F;
-      word = gatl::utility::number::part::first<uint16_t>(value);
-      Registers[i++] = word;
-      word = gatl::utility::number::part::second<uint16_t>(value);
-      Registers[i++] = word;
+      values[n] = 0.01F + floatcast + floatcast / 10.0F;
     }
+    setregisters(0, values.get(), count);
     break;
   }
   case Pattern::Int32:
   {
     size_t count = RegisterCount / 2;
+    std::unique_ptr<int32_t[]> values(new int32_t[count]);
     int32_t value = -static_cast<int32_t>(count);
-    size_t i = 0;
-    uint16_t word;
     for (size_t n = 0; n < count; n++) {
-      word = gatl::utility::number::part::first<uint16_t>(value);
-      Registers[i++] = word;
-      word = gatl::utility::number::part::second<uint16_t>(value);
-      Registers[i++] = word;
+      values[n] = value;
       value += 2;
     }
+    setregisters(0, values.get(), count);
     break;
   }
   }
-}
\ No newline at end of file
+}
+
+void Modbus::initialize(uint8_t unitAddress, int transmissionControlPin) {
+  for (size_t i = 0; i < CB_MAX; i++) {
+    cbVector[i] = nullptr;
+  }
+  Requests = 0;
+  Exceptions = 0;
+  Discarded = 0;
+  Busy = 0;
+  Charge = false;
+  CoilCount = 0;
+  DiscreteCount = 0;
+  RegisterCount = 0;
+  serial_ = nullptr;
+  unitAddress_ = unitAddress;
+  transmissionControlPin_ = transmissionControlPin;
+  exceptionStatus_ = 0;
+  requestLength_ = 0;
+  corrupt_ = false;
+  responseLength_ = 0;
+  frame_ = span(request_, 0);
+  wrap_ = span(request_, 0);
+  frameLength_ = 0;
+  reply_ = response_;
+  skip_ = 0;
+  totalBytesSent_ = 0;
+  totalBytesReceived_ = 0;
+}
+
+size_t Modbus::expected(const uint8_t* frame, const size_t& length) const {
+  if (length < 2) {
+    return 0;
+  }
+  switch (frame[1]) {
+  case FC_READ_COILS:
+  case FC_READ_DISCRETE_INPUT:
+  case FC_READ_HOLDING_REGISTERS:
+  case FC_READ_INPUT_REGISTERS:
+  case FC_WRITE_COIL:
+  case FC_WRITE_REGISTER:
+    return 8;
+  case FC_READ_EXCEPTION_STATUS:
+    return 4;
+  case FC_WRITE_MULTIPLE_COILS:
+  case FC_WRITE_MULTIPLE_REGISTERS:
+    return length < 7 ? 0 : 9 + static_cast<size_t>(frame[6]);
+  default:
+    return 0;
+  }
+}
+
+size_t Modbus::delimit(const Span& first, const Span& second) const {
+  size_t available = first.size + second.size;
+  if (available < 4) {
+    return 0;
+  }
+  size_t last = std::min(available, static_cast<size_t>(MODBUS_MAX_BUFFER));
+  /* The CRC of the bytes ahead of each candidate checksum in turn */
+  uint8_t header[2] = { octet(first, second, 0), octet(first, second, 1) };
+  uint16_t crc = Crc::update(Crc::initial(), header, sizeof(header));
+  for (size_t length = 4; length <= last; length++) {
+    uint8_t low = octet(first, second, length - 2);
+    if (Crc::finalize(crc) ==
+      (low | static_cast<uint16_t>(octet(first, second, length - 1)) << 8)) {
+      return length;
+    }
+    crc = Crc::update(crc, &low, 1);
+  }
+  /* No request is longer than the buffer, all of it is to be discarded */
+  return available >= MODBUS_MAX_BUFFER ? available : 0;
+}
+
+size_t Modbus::take(WordQueue& receive, uint8_t* reply) {
+  if (skip_ > 0) {
+    skip_ -= receive.drop(skip_);
+    if (skip_ > 0) {
+      return 0;
+    }
+  }
+  /* Parsed where it lies in the ring, also when the frame wraps */
+  Span first, second;
+  receive.peek(first, second);
+  uint8_t header[MODBUS_RTU_HEADER_SIZE];
+  gather(first, second, header, sizeof(header));
+  size_t available = first.size + second.size;
+  size_t length = available < 2 || known(header[1]) ?
+    expected(header, available) : delimit(first, second);
+  if (length > MODBUS_MAX_BUFFER) {
+    /* Drop all of it, also what is still to arrive, to stay in step */
+    Discarded++;
+    skip_ = length - receive.drop(length);
+    return 0;
+  } else if (length == 0 || available < length) {
+    return 0;
+  }
+  totalBytesReceived_ += length;
+  Span head, tail;
+  slice(first, second, 0, length, head, tail);
+  size_t replied = process(head, tail, reply);
+  receive.drop(length);
+  return replied;
+}
+
+size_t Modbus::process(
+  const Span& first,
+  const Span& second,
+  uint8_t* reply) {
+  frame_ = first;
+  wrap_ = second;
+  frameLength_ = first.size + second.size;
+  reply_ = reply;
+  responseLength_ = 0;
+  if (frameLength_ < 4 || !valid()) {
+    Discarded++;
+  } else if (at(0) == MODBUS_BROADCAST_ADDRESS && !broadcastable(at(1))) {
+    Discarded++;
+  } else if (
+    at(0) == unitAddress_ ||
+    at(0) == MODBUS_BROADCAST_ADDRESS) {
+    Requests++;
+    uint8_t status = dispatch();
+    if (status != STATUS_OK) {
+      Exceptions++;
+      exception(status);
+    }
+    if (isBroadcast()) {
+      responseLength_ = 0;
+    } else {
+      seal();
+    }
+  }
+  /* readFunctionCode and readUnitAddress are valid while callbacks run */
+  frameLength_ = 0;
+  return responseLength_;
+}
+
+size_t Modbus::respond(
+  const Span& first,
+  const Span& second,
+  uint8_t* reply) {
+  uint8_t mbap[MODBUS_TCP_HEADER_SIZE - 1];
+  gather(first, second, mbap, sizeof(mbap));
+  /* The unit closes the header, from there on the ADU is an RTU frame */
+  frameLength_ = first.size + second.size - sizeof(mbap);
+  slice(first, second, sizeof(mbap), frameLength_, frame_, wrap_);
+  uint8_t header[MODBUS_RTU_HEADER_SIZE];
+  gather(frame_, wrap_, header, sizeof(header));
+  reply_ = reply + sizeof(mbap);
+  responseLength_ = 0;
+  if (frameLength_ < 2 ||
+    mbap[2] != 0 || mbap[3] != 0 ||
+    (known(header[1]) && expected(header, frameLength_) != frameLength_ + 2)) {
+    Discarded++;
+  } else if (
+    at(0) == unitAddress_ ||
+    at(0) == MODBUS_BROADCAST_ADDRESS ||
+    at(0) == MODBUS_TCP_UNIT_ADDRESS) {
+    /* There is no broadcast on TCP, every request is answered */
+    Requests++;
+    uint8_t status = dispatch();
+    if (status != STATUS_OK) {
+      Exceptions++;
+      exception(status);
+    }
+    reply[0] = mbap[0];
+    reply[1] = mbap[1];
+    reply[2] = 0;
+    reply[3] = 0;
+    reply[4] = static_cast<uint8_t>(responseLength_ >> 8);
+    reply[5] = static_cast<uint8_t>(responseLength_ & 0xff);
+    responseLength_ += MODBUS_TCP_HEADER_SIZE - 1;
+  }
+  frameLength_ = 0;
+  return responseLength_;
+}
+
+uint8_t Modbus::dispatch() {
+  uint8_t function = at(1);
+  uint16_t address = word(2);
+  uint16_t length = word(4);
+  uint8_t status;
+  responseLength_ = 0;
+  append(at(0));
+  append(function);
+  switch (function) {
+  case FC_READ_COILS:
+  case FC_READ_DISCRETE_INPUT:
+  {
+    bool coils = function == FC_READ_COILS;
+    size_t count = coils ? CoilCount : DiscreteCount;
+    if (length == 0 || length > MODBUS_MAX_READ_BITS) {
+      return STATUS_ILLEGAL_DATA_VALUE;
+    }
+    if (static_cast<size_t>(address) + length > count) {
+      return STATUS_ILLEGAL_DATA_ADDRESS;
+    }
+    status = callback(
+      coils ? CB_READ_COILS : CB_READ_DISCRETE_INPUTS, address, length);
+    if (status == STATUS_OK) {
+      append(static_cast<uint8_t>((length + 7) / 8));
+      (coils ? Coils : Discretes).pack(reply_ + responseLength_, address, length);
+      responseLength_ += (length + 7) / 8;
+    }
+    return status;
+  }
+  case FC_READ_HOLDING_REGISTERS:
+  case FC_READ_INPUT_REGISTERS:
+    if (length == 0 || length > MODBUS_MAX_READ_REGISTERS) {
+      return STATUS_ILLEGAL_DATA_VALUE;
+    }
+    if (static_cast<size_t>(address) + length > RegisterCount) {
+      return STATUS_ILLEGAL_DATA_ADDRESS;
+    }
+    status = callback(
+      function == FC_READ_HOLDING_REGISTERS ?
+        CB_READ_HOLDING_REGISTERS : CB_READ_INPUT_REGISTERS,
+      address,
+      length);
+    if (status == STATUS_OK) {
+      append(static_cast<uint8_t>(2 * length));
+      appendwords(Registers.get() + address, length);
+    }
+    return status;
+  case FC_WRITE_COIL:
+    if (length != COIL_OFF && length != COIL_ON) {
+      return STATUS_ILLEGAL_DATA_VALUE;
+    }
+    if (address >= CoilCount) {
+      return STATUS_ILLEGAL_DATA_ADDRESS;
+    }
+    Coils.set(address, length == COIL_ON);
+    status = callback(CB_WRITE_COILS, address, 1);
+    if (status == STATUS_OK) {
+      appendword(address);
+      appendword(length);
+    }
+    return status;
+  case FC_WRITE_REGISTER:
+    if (address >= RegisterCount) {
+      return STATUS_ILLEGAL_DATA_ADDRESS;
+    }
+    Registers[address] = length;
+    status = callback(CB_WRITE_HOLDING_REGISTERS, address, 1);
+    if (status == STATUS_OK) {
+      appendword(address);
+      appendword(length);
+    }
+    return status;
+  case FC_READ_EXCEPTION_STATUS:
+    status = callback(CB_READ_EXCEPTION_STATUS, 0, 8);
+    if (status == STATUS_OK) {
+      append(exceptionStatus_);
+    }
+    return status;
+  case FC_WRITE_MULTIPLE_COILS:
+    if (length == 0 || length > MODBUS_MAX_WRITE_BITS ||
+      at(6) != (length + 7) / 8) {
+      return STATUS_ILLEGAL_DATA_VALUE;
+    }
+    if (static_cast<size_t>(address) + length > CoilCount) {
+      return STATUS_ILLEGAL_DATA_ADDRESS;
+    }
+    {
+      Span head, tail;
+      slice(frame_, wrap_, 7, at(6), head, tail);
+      size_t bits = std::min<size_t>(8 * head.size, length);
+      Coils.unpack(head.data, address, bits);
+      Coils.unpack(tail.data, address + bits, length - bits);
+    }
+    status = callback(CB_WRITE_COILS, address, length);
+    if (status == STATUS_OK) {
+      appendword(address);
+      appendword(length);
+    }
+    return status;
+  case FC_WRITE_MULTIPLE_REGISTERS:
+    if (length == 0 || length > MODBUS_MAX_WRITE_REGISTERS ||
+      at(6) != 2 * length) {
+      return STATUS_ILLEGAL_DATA_VALUE;
+    }
+    if (static_cast<size_t>(address) + length > RegisterCount) {
+      return STATUS_ILLEGAL_DATA_ADDRESS;
+    }
+    {
+      Span head, tail;
+      slice(frame_, wrap_, 7, 2 * length, head, tail);
+      uint16_t* registers = Registers.get() + address;
+      size_t whole = head.size / 2;
+      gatuo::load(registers, head.data, whole);
+      if (head.size % 2) {
+        /* The ring wraps inside this register */
+        registers[whole++] = static_cast<uint16_t>(
+          head.data[head.size - 1]) << 8 | tail.data[0];
+        gatuo::load(registers + whole, tail.data + 1, length - whole);
+      } else {
+        gatuo::load(registers + whole, tail.data, length - whole);
+      }
+    }
+    status = callback(CB_WRITE_HOLDING_REGISTERS, address, length);
+    if (status == STATUS_OK) {
+      appendword(address);
+      appendword(length);
+    }
+    return status;
+  default:
+    return STATUS_ILLEGAL_FUNCTION;
+  }
+}
+
+uint8_t Modbus::callback(uint8_t index, uint16_t address, uint16_t length) {
+  if (cbVector[index] != nullptr) {
+    return cbVector[index](at(1), address, length);
+  }
+  return STATUS_OK;
+}
+
+uint8_t Modbus::exception(uint8_t status) {
+  responseLength_ = 0;
+  append(at(0));
+  append(at(1) | 0x80);
+  append(status);
+  return status;
+}
+
+void Modbus::seal() {
+  uint16_t crc = Crc::calculate(reply_, responseLength_);
+  append(static_cast<uint8_t>(crc & 0xff));
+  append(static_cast<uint8_t>(crc >> 8));
+}
+
+uint8_t Modbus::transmit(const size_t& length) {
+  if (length == 0) {
+    return 0;
+  }
+  if (transmissionControlPin_ > MODBUS_CONTROL_PIN_NONE) {
+    digitalWrite(transmissionControlPin_, HIGH);
+  }
+  size_t written = serial_->write(response_, length);
+  serial_->flush();
+  if (transmissionControlPin_ > MODBUS_CONTROL_PIN_NONE) {
+    digitalWrite(transmissionControlPin_, LOW);
+  }
+  totalBytesSent_ += written;
+  return static_cast<uint8_t>(written);
+}
+
+bool Modbus::valid() const {
+  Span head, tail;
+  slice(frame_, wrap_, 0, frameLength_ - 2, head, tail);
+  uint16_t crc = Crc::update(Crc::initial(), head.data, head.size);
+  crc = Crc::finalize(Crc::update(crc, tail.data, tail.size));
+  return crc == (at(frameLength_ - 2) |
+    static_cast<uint16_t>(at(frameLength_ - 1)) << 8);
+}
+
+uint8_t Modbus::at(const size_t& index) const {
+  return index < frame_.size ?
+    frame_.data[index] : wrap_.data[index - frame_.size];
+}
+
+uint16_t Modbus::word(const size_t& index) const {
+  return static_cast<uint16_t>(at(index)) << 8 | at(index + 1);
+}
+
+void Modbus::append(const uint8_t& byte) {
+  reply_[responseLength_++] = byte;
+}
+
+void Modbus::appendword(const uint16_t& word) {
+  append(static_cast<uint8_t>(word >> 8));
+  append(static_cast<uint8_t>(word & 0xff));
+}
+
+void Modbus::appendwords(const uint16_t* words, const size_t& count) {
+  gatuo::store(reply_ + responseLength_, words, count);
+  responseLength_ += 2 * count;
+}
+
+}
+}
+}
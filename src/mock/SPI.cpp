@@ -1,5 +1,6 @@
 #include <SPI.h>
 
+#include <cstring>
 #include <iostream>
 
 SPISettings::SPISettings() {
@@ -10,8 +11,11 @@ SPISettings::SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) {
   init(clock, bitOrder, dataMode);
 }
 
-SPISettings::SPISettings(const SPISettings& settings) {
-  init(settings.clock_, settings.bitOrder_, settings.dataMode_);
+SPISettings::SPISettings(const SPISettings& settings) :
+  clock_(settings.clock_),
+  bitOrder_(settings.bitOrder_),
+  dataMode_(settings.dataMode_),
+  clockDiv_(settings.clockDiv_) {
 }
 
 bool SPISettings::operator==(const SPISettings& rhs) const {
@@ -40,45 +44,16 @@ void SPISettings::init(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) {
 // given clock rate. The clock divider that results in clock_setting
 // is 2 ^^ (clock_div + 1). If nothing is slow enough, we'll use the
 // slowest (128 == 2 ^^ 7, so clock_div = 6).
-  //uint8_t clockDiv;
-
-  // When the clock is known at compiletime, use this if-then-else
-  // cascade, which the compiler knows how to completely optimize
-  // away. When clock is not known, use a loop instead, which generates
-  // shorter code.
-  /*
-  if (__builtin_constant_p(clock)) {
-    if (clock >= F_CPU / 2) {
-      clockDiv = 0;
-    }
-    else if (clock >= F_CPU / 4) {
-      clockDiv = 1;
-    }
-    else if (clock >= F_CPU / 8) {
-      clockDiv = 2;
-    }
-    else if (clock >= F_CPU / 16) {
-      clockDiv = 3;
-    }
-    else if (clock >= F_CPU / 32) {
-      clockDiv = 4;
-    }
-    else if (clock >= F_CPU / 64) {
-      clockDiv = 5;
-    }
-    else {
-      clockDiv = 6;
-    }
-  }
-  else {
-    uint32_t clockSetting = F_CPU / 2;
-    clockDiv = 0;
-    while (clockDiv < 6 && clock < clockSetting) {
-      clockSetting /= 2;
-      clockDiv++;
-    }
+  // The mock only keeps the loop variant of the AVR library, there is
+  // no code size to save with the compile time cascade.
+  uint32_t clockSetting = F_CPU / 2;
+  clockDiv_ = 0;
+  while (clockDiv_ < 6 && clock < clockSetting) {
+    clockSetting /= 2;
+    clockDiv_++;
   }
 
+  /*
   // Compensate for the duplicate fosc/64
   if (clockDiv == 6)
     clockDiv = 7;
@@ -93,26 +68,96 @@ void SPISettings::init(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) {
   */
 }
 
-uint8_t SpiMock::transfer(uint8_t data) {
-  uint8_t result = 0x00;
-  In.pushbyte(data);
-  if (Out.bytes() > 0) {
-    Out.popbyte(result);
+uint32_t SPISettings::frequency() const {
+  return static_cast<uint32_t>(F_CPU) >> (clockDiv_ + 1);
+}
+
+SpiStatistics::SpiStatistics() : Bytes(0), Transactions(0), Nanoseconds(0) {
+}
+
+double SpiStatistics::microseconds() const {
+  return static_cast<double>(Nanoseconds) / 1000.0;
+}
+
+SpiMock::SpiMock() :
+  Fill(0x00),
+  Underrun(0),
+  Capture(true),
+  Mismatch(0),
+  Nanoseconds(0),
+  selected_(nullptr),
+  chipselect_(SPI_NO_CHIP_SELECT) {
+}
+
+void SpiMock::attach(uint8_t pin, Device* device) {
+  Devices[pin] = device;
+}
+
+void SpiMock::detach(uint8_t pin) {
+  DeviceMap::iterator it = Devices.find(pin);
+  if (it != Devices.end()) {
+    if (it->second == selected_) {
+      selected_ = nullptr;
+    }
+    Devices.erase(it);
+  }
+}
+
+void SpiMock::chipselect(uint8_t pin, uint8_t value) {
+  if (value == LOW) {
+    if (chipselect_ != pin) {
+      chipselect_ = pin;
+      Statistics[pin].Transactions++;
+    }
+  } else if (chipselect_ == pin) {
+    chipselect_ = SPI_NO_CHIP_SELECT;
+  }
+  DeviceMap::iterator it = Devices.find(pin);
+  if (it != Devices.end()) {
+    if (value == LOW) {
+      if (selected_ && selected_ != it->second) {
+        std::cout << "Warning: Selecting multiple SPI devices" << std::endl;
+        selected_->deselect();
+      }
+      selected_ = it->second;
+      selected_->select();
+    } else if (selected_ == it->second) {
+      selected_->deselect();
+      selected_ = nullptr;
+    }
   }
-  return result;
+}
+
+const SPISettings& SpiMock::settings() const {
+  if (TransactionQueue.empty()) {
+    return default_;
+  } else {
+    return TransactionQueue.back();
+  }
+}
+
+uint8_t SpiMock::transfer(uint8_t data) {
+  exchange(&data, 1);
+  return data;
 }
 
 uint16_t SpiMock::transfer16(uint16_t data) {
-  uint16_t result = 0x0000;
-  In.pushword(data);
-  if (Out.bytes() > 1) {
-    Out.popword(result);
+  namespace gatub = ::gos::arduino::testing::utils::byte;
+  // Words go in the byte order of Out, filled bytes included, and the
+  // AVR library shifts the other byte first for LSBFIRST
+  gatub::Order order = Out.order();
+  if (settings().bitOrder_ == LSBFIRST) {
+    order = gatub::contrary(order);
   }
-  return result;
+  uint8_t bytes[2] = {
+    gatub::fyrstbyte(data, order),
+    gatub::secondbyte(data, order) };
+  exchange(bytes, 2);
+  return gatub::combine(bytes[0], bytes[1], order);
 }
 
 void SpiMock::transfer(void *buf, size_t count) {
-  In.pushbytes(static_cast<uint8_t*>(buf), count);
+  exchange(static_cast<uint8_t*>(buf), count);
 }
 
 void SpiMock::beginTransaction(SPISettings settings) {
@@ -130,7 +175,55 @@ void SpiMock::endTransaction() {
   }
 }
 
-static SpiMock* gSpiMock = nullptr;
+void SpiMock::account(const size_t& bytes) {
+  uint32_t frequency = settings().frequency();
+  uint64_t nanoseconds = (8000000000ULL * bytes) / frequency;
+  SpiStatistics& statistics = Statistics[chipselect_];
+  statistics.Bytes += bytes;
+  statistics.Nanoseconds += nanoseconds;
+  Nanoseconds += nanoseconds;
+}
+
+void SpiMock::exchange(uint8_t* bytes, const size_t& count) {
+  namespace gatubit = ::gos::arduino::testing::utils::bit;
+  const SPISettings& current = settings();
+  bool lsbfirst = current.bitOrder_ == LSBFIRST;
+  account(count);
+  // Values to wire order
+  if (lsbfirst) {
+    gatubit::reverse(bytes, count);
+  }
+  if (Capture) {
+    In.pushbytes(bytes, count);
+  }
+  if (selected_) {
+    uint8_t mode = (current.dataMode_ & SPI_MODE_MASK) >> 2;
+    if (!(selected_->Modes & (1 << mode))) {
+      Mismatch += count;
+    }
+    bool devicelsbfirst = selected_->BitOrder == gatubit::Order::LsbFirst;
+    if (devicelsbfirst) {
+      gatubit::reverse(bytes, count);
+    }
+    selected_->transfer(bytes, count);
+    if (devicelsbfirst) {
+      gatubit::reverse(bytes, count);
+    }
+  } else {
+    size_t received = Out.popbytes(bytes, count);
+    if (received < count) {
+      ::memset(bytes + received, Fill, count - received);
+      Underrun += count - received;
+    }
+  }
+  // Wire order back to values
+  if (lsbfirst) {
+    gatubit::reverse(bytes, count);
+  }
+}
+
+// Each thread gets its own bus so independent tests can run concurrently
+static thread_local SpiMock* gSpiMock = nullptr;
 SpiMock* spiMockInstance() {
   if (!gSpiMock) {
     gSpiMock = new SpiMock();
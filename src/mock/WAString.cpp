@@ -1,23 +1,29 @@
-#include <sstream>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include <avr/dtostrf.h>
+
+#include <gos/utils/digits.h>
 
 #include <mock/WAString.h>
 
+// Sign, the 309 integer digits of DBL_MAX, the point, the 255 decimals
+// dtostrf takes at most and the terminating NUL
+#define WASTRING_FLOAT_BUFFER (1 + 309 + 1 + 255 + 1)
+
+namespace gatud = ::gos::arduino::testing::utils::digits;
+
 namespace gos {
 namespace arduino {
 namespace mock {
 /* default implementation: may be overridden */
 size_t Print::write(const uint8_t* buffer, size_t size)
 {
-  size_t n = 0;
-  while (size--) {
-    if(*buffer) {
-      s_ << (char)(*buffer);
-      buffer++;
-      n++;
-    } else {
-      break;
-    }
-  }
+  size_t n = sink_ ? sink_->write(buffer, size) : buffer_.write(buffer, size);
+  if (n < size) setWriteError();
   return n;
 }
 
@@ -57,9 +63,7 @@ size_t Print::print(long n, int base)
     return write(n);
   } else if (base == 10) {
     if (n < 0) {
-      int t = print('-');
-      n = -n;
-      return printNumber(n, 10) + t;
+      return printNumber(0UL - (unsigned long)n, 10, true);
     }
     return printNumber(n, 10);
   } else {
@@ -148,39 +152,33 @@ size_t Print::println(double num, int digits)
 
 // Private Methods /////////////////////////////////////////////////////////////
 
-size_t Print::printNumber(unsigned long n, uint8_t base)
+size_t Print::printNumber(unsigned long n, uint8_t base, bool negative)
 {
-  char buf[8 * sizeof(long) + 1]; // Assumes 8-bit chars plus zero byte.
-  char* str = &buf[sizeof(buf) - 1];
-
-  *str = '\0';
+  char buf[GOS_ARDUINO_TESTING_DIGITS_BUFFER];
+  char* end = buf + sizeof(buf);
 
-  // prevent crash if called with base == 1
-  if (base < 2) base = 10;
+  // a base below 2 prints as decimal
+  char* str = gatud::format(n, end, base);
+  if (negative) *--str = '-';
 
-  do {
-    char c = n % base;
-    n /= base;
-
-    *--str = c < 10 ? c + '0' : c + 'A' - 10;
-  } while (n);
-
-  return write(str);
+  return write(str, end - str);
 }
 
 size_t Print::printFloat(double number, uint8_t digits)
 {
-  size_t n = 0;
-
-  if (isnan(number)) return print("nan");
-  if (isinf(number)) return print("inf");
+  if (std::isnan(number)) return print("nan");
+  if (std::isinf(number)) return print("inf");
   if (number > 4294967040.0) return print("ovf");  // constant determined empirically
   if (number < -4294967040.0) return print("ovf");  // constant determined empirically
 
+  // Sign, ten integer digits, the point and every decimal in one write
+  char buf[12 + 255];
+  char* str = buf;
+
   // Handle negative numbers
   if (number < 0.0)
   {
-    n += print('-');
+    *str++ = '-';
     number = -number;
   }
 
@@ -191,14 +189,18 @@ size_t Print::printFloat(double number, uint8_t digits)
 
   number += rounding;
 
-  // Extract the integer part of the number and print it
+  // Extract the integer part of the number, digits land at the back
   unsigned long int_part = (unsigned long)number;
   double remainder = number - (double)int_part;
-  n += print(int_part);
+  char integer[GOS_ARDUINO_TESTING_DIGITS_BUFFER];
+  char* end = integer + sizeof(integer);
+  char* first = gatud::format(int_part, end);
+  ::memcpy(str, first, end - first);
+  str += end - first;
 
   // Print the decimal point, but only if there are digits beyond
   if (digits > 0) {
-    n += print('.');
+    *str++ = '.';
   }
 
   // Extract digits from the remainder one at a time
@@ -206,176 +208,545 @@ size_t Print::printFloat(double number, uint8_t digits)
   {
     remainder *= 10.0;
     unsigned int toPrint = (unsigned int)(remainder);
-    n += print(toPrint);
+    *str++ = '0' + (char)toPrint;
     remainder -= toPrint;
   }
 
-  return n;
+  return write(buf, str - buf);
 }
 
-typedef std::stringstream Stream;
-
-
 }
 }
 }
 
 namespace gam = ::gos::arduino::mock;
 
+String::Heap* String::arena_ = nullptr;
 
-String::String(const char* cstr) : s_(cstr) {
+void String::arena(Heap* heap) {
+  arena_ = heap;
 }
 
-String::String(const String& str) : s_(str.s_) {
+String::Heap* String::arena() {
+  return arena_;
+}
+
+String::String(const char* cstr) {
+  init();
+  if (cstr) copy(cstr, (unsigned int)strlen(cstr));
+}
+
+String::String(const String& str) {
+  init();
+  *this = str;
+}
+
+String::String(String&& rval) {
+  init();
+  move(rval);
 }
 
 String::String(char c) {
-  gam::Stream s;
-  s << c;
-  s_ = s.str();
+  init();
+  char buf[2] = { c, '\0' };
+  copy(buf, 1);
 }
 
+// Lowercase digits as avr-libc itoa writes them, a minus in base 10 only
+String::String(unsigned char value, unsigned char base) {
+  init();
+  char buf[GOS_ARDUINO_TESTING_DIGITS_BUFFER];
+  char* end = buf + sizeof(buf);
+  char* first = gatud::format(value, end, base, false);
+  copy(first, (unsigned int)(end - first));
+}
 String::String(int value, unsigned char base) {
-  gam::Print print;
-  print.println(value, base);
-  s_ = print.s_.str();
+  init();
+  char buf[GOS_ARDUINO_TESTING_DIGITS_BUFFER];
+  char* end = buf + sizeof(buf);
+  char* first = base == 10 ? gatud::formatsigned(value, end, base, false) :
+    gatud::format((unsigned int)value, end, base, false);
+  copy(first, (unsigned int)(end - first));
 }
 String::String(unsigned int value, unsigned char base) {
-  gam::Print print;
-  print.println(value, base);
-  s_ = print.s_.str();
+  init();
+  char buf[GOS_ARDUINO_TESTING_DIGITS_BUFFER];
+  char* end = buf + sizeof(buf);
+  char* first = gatud::format(value, end, base, false);
+  copy(first, (unsigned int)(end - first));
 }
 String::String(long value, unsigned char base) {
-  gam::Print print;
-  print.println(value, base);
-  s_ = print.s_.str();
+  init();
+  char buf[GOS_ARDUINO_TESTING_DIGITS_BUFFER];
+  char* end = buf + sizeof(buf);
+  char* first = base == 10 ? gatud::formatsigned(value, end, base, false) :
+    gatud::format((unsigned long)value, end, base, false);
+  copy(first, (unsigned int)(end - first));
 }
 String::String(unsigned long value, unsigned char base) {
-  gam::Print print;
-  print.println(value, base);
-  s_ = print.s_.str();
+  init();
+  char buf[GOS_ARDUINO_TESTING_DIGITS_BUFFER];
+  char* end = buf + sizeof(buf);
+  char* first = gatud::format(value, end, base, false);
+  copy(first, (unsigned int)(end - first));
 }
 String::String(float value, unsigned char decimalPlaces) {
-  gam::Print print;
-  print.println(value, decimalPlaces);
-  s_ = print.s_.str();
+  init();
+  char buf[WASTRING_FLOAT_BUFFER];
+  *this = dtostrf(value, (decimalPlaces + 2), decimalPlaces, buf);
 }
 String::String(double value, unsigned char decimalPlaces) {
-  gam::Print print;
-  print.println(value, decimalPlaces);
-  s_ = print.s_.str();
+  init();
+  char buf[WASTRING_FLOAT_BUFFER];
+  *this = dtostrf(value, (decimalPlaces + 2), decimalPlaces, buf);
+}
+
+String::~String(void) {
+  release();
 }
 
-String::~String(void) {}
+// memory management
 
-unsigned char reserve(unsigned int size) {
-  return size;
+void String::init(void) {
+  heap_ = arena_;
+  len_ = 0;
+  inline_[0] = '\0';
+  if (heap_) {
+    // A device allocates even the empty string, start out invalid
+    buffer_ = nullptr;
+    capacity_ = 0;
+  } else {
+    buffer_ = inline_;
+    capacity_ = STRING_INLINE_SIZE - 1;
+  }
 }
 
-String& String::operator = (const String& rhs) {
-  if (&rhs != this) {
-    s_ = rhs.s_;
+void String::release(void) {
+  if (buffer_ == nullptr || buffer_ == inline_) return;
+  if (heap_) heap_->release(buffer_);
+  else ::free(buffer_);
+}
+
+void String::invalidate(void) {
+  release();
+  buffer_ = nullptr;
+  capacity_ = len_ = 0;
+}
+
+unsigned char String::reserve(unsigned int size) {
+  if (buffer_ && capacity_ >= size) return 1;
+  if (changeBuffer(size)) {
+    if (len_ == 0) buffer_[0] = '\0';
+    return 1;
   }
+  return 0;
+}
+
+unsigned char String::changeBuffer(unsigned int maxStrLen) {
+  char* newbuffer;
+  if (heap_) {
+    // Exactly what is asked for, as the device does
+    newbuffer = (char*)heap_->reallocate(buffer_, maxStrLen + 1);
+  } else {
+    // Grow by half again so appending in a loop stays linear
+    unsigned int grown = capacity_ + capacity_ / 2;
+    if (maxStrLen < grown) maxStrLen = grown;
+    if (buffer_ == inline_) {
+      newbuffer = (char*)::malloc(maxStrLen + 1);
+      if (newbuffer) ::memcpy(newbuffer, inline_, len_ + 1);
+    } else {
+      newbuffer = (char*)::realloc(buffer_, maxStrLen + 1);
+    }
+  }
+  if (newbuffer == nullptr) return 0;
+  buffer_ = newbuffer;
+  capacity_ = maxStrLen;
+  return 1;
+}
+
+// copy and move
+
+String& String::copy(const char* cstr, unsigned int length) {
+  if (!reserve(length)) {
+    invalidate();
+    return *this;
+  }
+  len_ = length;
+  ::memmove(buffer_, cstr, length);
+  buffer_[len_] = '\0';
   return *this;
 }
+
+void String::move(String& rhs) {
+  if (this == &rhs) return;
+  if (rhs.buffer_ == nullptr) {
+    invalidate();
+  } else if (rhs.buffer_ == rhs.inline_ || rhs.heap_ != heap_) {
+    copy(rhs.buffer_, rhs.len_);
+  } else {
+    release();
+    buffer_ = rhs.buffer_;
+    capacity_ = rhs.capacity_;
+    len_ = rhs.len_;
+    rhs.init();
+    return;
+  }
+  rhs.release();
+  rhs.init();
+}
+
+String& String::operator = (const String& rhs) {
+  if (this == &rhs) return *this;
+  if (rhs.buffer_) copy(rhs.buffer_, rhs.len_);
+  else invalidate();
+  return *this;
+}
+
+String& String::operator = (String&& rval) {
+  move(rval);
+  return *this;
+}
+
 String& String::operator = (const char* cstr) {
-  s_ = cstr;
+  if (cstr) copy(cstr, (unsigned int)strlen(cstr));
+  else invalidate();
+  return *this;
 }
 
-unsigned char String::concat(const String& str) {
-  s_ += str.s_;
+// concat
+
+unsigned char String::concat(const char* cstr, unsigned int length) {
+  if (!cstr) return 0;
+  if (length == 0) return 1;
+  // The source may be this string's own buffer, which reserve can move
+  const char* base = buffer_;
+  bool self = base && cstr >= base && cstr < base + len_;
+  unsigned int newlen = len_ + length;
+  if (!reserve(newlen)) return 0;
+  if (self) cstr = buffer_ + (cstr - base);
+  ::memmove(buffer_ + len_, cstr, length);
+  len_ = newlen;
+  buffer_[len_] = '\0';
   return 1;
 }
+
+unsigned char String::concat(const String& str) {
+  return concat(str.buffer_, str.len_);
+}
 unsigned char String::concat(const char* cstr) {
-  s_ += cstr;
-  return 1;
+  if (!cstr) return 0;
+  return concat(cstr, (unsigned int)strlen(cstr));
 }
 unsigned char String::concat(char c) {
-  return concat(String(c));
+  return concat(&c, 1);
 }
-unsigned char String::concat(unsigned char c) {
-  return concat(String(c));
+unsigned char String::concat(unsigned char num) {
+  char buf[GOS_ARDUINO_TESTING_DIGITS_BUFFER];
+  char* end = buf + sizeof(buf);
+  char* first = gatud::format(num, end);
+  return concat(first, (unsigned int)(end - first));
 }
 unsigned char String::concat(int num) {
-  return concat(String(num));
+  char buf[GOS_ARDUINO_TESTING_DIGITS_BUFFER];
+  char* end = buf + sizeof(buf);
+  char* first = gatud::formatsigned(num, end);
+  return concat(first, (unsigned int)(end - first));
 }
 unsigned char String::concat(unsigned int num) {
-  return concat(String(num));
+  char buf[GOS_ARDUINO_TESTING_DIGITS_BUFFER];
+  char* end = buf + sizeof(buf);
+  char* first = gatud::format(num, end);
+  return concat(first, (unsigned int)(end - first));
 }
 unsigned char String::concat(long num) {
-  return concat(String(num));
+  char buf[GOS_ARDUINO_TESTING_DIGITS_BUFFER];
+  char* end = buf + sizeof(buf);
+  char* first = gatud::formatsigned(num, end);
+  return concat(first, (unsigned int)(end - first));
 }
 unsigned char String::concat(unsigned long num) {
-  return concat(String(num));
+  char buf[GOS_ARDUINO_TESTING_DIGITS_BUFFER];
+  char* end = buf + sizeof(buf);
+  char* first = gatud::format(num, end);
+  return concat(first, (unsigned int)(end - first));
 }
 unsigned char String::concat(float num) {
-  return concat(String(num));
+  char buf[WASTRING_FLOAT_BUFFER];
+  char* str = dtostrf(num, 4, 2, buf);
+  return concat(str, (unsigned int)strlen(str));
 }
 unsigned char String::concat(double num) {
-  return concat(String(num));
+  char buf[WASTRING_FLOAT_BUFFER];
+  char* str = dtostrf(num, 4, 2, buf);
+  return concat(str, (unsigned int)strlen(str));
 }
 
+// comparison
+
 int String::compareTo(const String& s) const {
-  s_.compare(s.s_);
+  if (!buffer_ || !s.buffer_) {
+    if (s.buffer_ && s.len_ > 0) return 0 - *(unsigned char*)s.buffer_;
+    if (buffer_ && len_ > 0) return *(unsigned char*)buffer_;
+    return 0;
+  }
+  return strcmp(buffer_, s.buffer_);
 }
 unsigned char String::equals(const String& s) const {
-  return s_.compare(s.s_) == 0 ? 1 : 0;
+  return (len_ == s.len_ && compareTo(s) == 0);
 }
 unsigned char String::equals(const char* cstr) const {
-  return s_.compare(cstr) == 0 ? 1 : 0;
+  if (len_ == 0) return (cstr == nullptr || *cstr == 0);
+  if (cstr == nullptr) return buffer_[0] == 0;
+  return strcmp(buffer_, cstr) == 0;
 }
 
 unsigned char String::operator <  (const String& rhs) const {
-  return s_.compare(rhs.s_) < 0;
-
+  return compareTo(rhs) < 0;
 }
 unsigned char String::operator >  (const String& rhs) const {
-  return s_.compare(rhs.s_) > 0;
+  return compareTo(rhs) > 0;
 }
 unsigned char String::operator <= (const String& rhs) const {
-  return s_.compare(rhs.s_) <= 0;
+  return compareTo(rhs) <= 0;
 }
 unsigned char String::operator >= (const String& rhs) const {
-  return s_.compare(rhs.s_) >= 0;
+  return compareTo(rhs) >= 0;
 }
 
 unsigned char String::equalsIgnoreCase(const String& s) const {
-  
+  if (this == &s) return 1;
+  if (len_ != s.len_) return 0;
+  if (len_ == 0) return 1;
+  for (unsigned int i = 0; i < len_; i++) {
+    if (tolower((unsigned char)buffer_[i]) !=
+      tolower((unsigned char)s.buffer_[i])) return 0;
+  }
+  return 1;
 }
 unsigned char String::startsWith(const String& prefix) const {
-
+  if (len_ < prefix.len_) return 0;
+  return startsWith(prefix, 0);
 }
 unsigned char String::startsWith(const String& prefix, unsigned int offset) const {
-
+  if (prefix.len_ > len_ || offset > len_ - prefix.len_ || !buffer_ || !prefix.buffer_) return 0;
+  return ::memcmp(&buffer_[offset], prefix.buffer_, prefix.len_) == 0;
 }
 unsigned char String::endsWith(const String& suffix) const {
-
+  if (len_ < suffix.len_ || !buffer_ || !suffix.buffer_) return 0;
+  return ::memcmp(&buffer_[len_ - suffix.len_], suffix.buffer_, suffix.len_) == 0;
 }
 
 // character acccess
 char String::charAt(unsigned int index) const {
-  return s_.at(index);
+  return operator[](index);
 }
 void String::setCharAt(unsigned int index, char c) {
-  s_[index] = c;
+  if (index < len_) buffer_[index] = c;
 }
 char String::operator [] (unsigned int index) const {
-  return s_.at(index);
+  if (index >= len_ || !buffer_) return 0;
+  return buffer_[index];
 }
 char& String::operator [] (unsigned int index) {
-  return s_.at(index);
+  static char dummy_writable_char;
+  if (index >= len_ || !buffer_) {
+    dummy_writable_char = 0;
+    return dummy_writable_char;
+  }
+  return buffer_[index];
+}
+void String::getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index) const {
+  if (!bufsize || !buf) return;
+  if (index >= len_) {
+    buf[0] = 0;
+    return;
+  }
+  unsigned int n = bufsize - 1;
+  if (n > len_ - index) n = len_ - index;
+  ::memcpy(buf, buffer_ + index, n);
+  buf[n] = 0;
 }
-void String::getBytes(unsigned char* buf, unsigned int bufsize, unsigned int index = 0) const {
-  unsigned int size = min(bufsize, s_.length() + 1);
-  ::memcpy(buf, s_.c_str(), size);
+
+String String::substring(unsigned int left, unsigned int right) const {
+  if (left > right) {
+    unsigned int temp = right;
+    right = left;
+    left = temp;
+  }
+  String out;
+  if (left >= len_) return out;
+  if (right > len_) right = len_;
+  out.copy(buffer_ + left, right - left);
+  return out;
 }
 
 // search
-int String::indexOf(char ch) const;
-int String::indexOf(char ch, unsigned int fromIndex) const;
-int String::indexOf(const String& str) const;
-int String::indexOf(const String& str, unsigned int fromIndex) const;
-int String::lastIndexOf(char ch) const;
-int String::lastIndexOf(char ch, unsigned int fromIndex) const;
-int String::lastIndexOf(const String& str) const;
-int String::lastIndexOf(const String& str, unsigned int fromIndex) const;
+
+int String::indexOf(char ch) const {
+  return indexOf(ch, 0);
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const {
+  if (fromIndex >= len_) return -1;
+  const char* found = (const char*)::memchr(buffer_ + fromIndex, ch, len_ - fromIndex);
+  if (found == nullptr) return -1;
+  return (int)(found - buffer_);
+}
+
+int String::indexOf(const String& str) const {
+  return indexOf(str, 0);
+}
+
+int String::indexOf(const String& str, unsigned int fromIndex) const {
+  if (fromIndex >= len_ || !str.buffer_) return -1;
+  if (str.len_ == 0) return (int)fromIndex;
+  if (str.len_ > len_ - fromIndex) return -1;
+  // memchr finds the candidates, memcmp checks the rest of each
+  const char* last = buffer_ + len_ - str.len_;
+  const char* p = buffer_ + fromIndex;
+  while (p <= last) {
+    p = (const char*)::memchr(p, str.buffer_[0], last - p + 1);
+    if (p == nullptr) return -1;
+    if (::memcmp(p + 1, str.buffer_ + 1, str.len_ - 1) == 0) return (int)(p - buffer_);
+    p++;
+  }
+  return -1;
+}
+
+int String::lastIndexOf(char ch) const {
+  return lastIndexOf(ch, len_ - 1);
+}
+
+int String::lastIndexOf(char ch, unsigned int fromIndex) const {
+  if (fromIndex >= len_) return -1;
+  for (unsigned int i = fromIndex + 1; i-- > 0;) {
+    if (buffer_[i] == ch) return (int)i;
+  }
+  return -1;
+}
+
+int String::lastIndexOf(const String& str) const {
+  return lastIndexOf(str, len_ - str.len_);
+}
+
+int String::lastIndexOf(const String& str, unsigned int fromIndex) const {
+  if (str.len_ == 0 || len_ == 0 || str.len_ > len_) return -1;
+  if (fromIndex > len_ - str.len_) fromIndex = len_ - str.len_;
+  for (unsigned int i = fromIndex + 1; i-- > 0;) {
+    if (buffer_[i] == str.buffer_[0] && ::memcmp(buffer_ + i, str.buffer_, str.len_) == 0) {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+// modification
+
+void String::replace(char find, char replace) {
+  if (!buffer_) return;
+  char* end = buffer_ + len_;
+  for (char* p = buffer_; (p = (char*)::memchr(p, find, end - p)) != nullptr; p++) {
+    *p = replace;
+  }
+}
+
+void String::replace(const String& find, const String& replace) {
+  if (len_ == 0 || find.len_ == 0 || !replace.buffer_) return;
+  if (&find == this || &replace == this) {
+    String findcopy(find), replacecopy(replace);
+    this->replace(findcopy, replacecopy);
+    return;
+  }
+
+  if (replace.len_ <= find.len_) {
+    // One pass that writes behind where it reads, in place
+    char* write = buffer_;
+    int from = 0, at;
+    while ((at = indexOf(find, from)) >= 0) {
+      unsigned int kept = at - from;
+      if (write != buffer_ + from) ::memmove(write, buffer_ + from, kept);
+      write += kept;
+      ::memcpy(write, replace.buffer_, replace.len_);
+      write += replace.len_;
+      from = at + find.len_;
+    }
+    if (write == buffer_ + from) return;
+    ::memmove(write, buffer_ + from, len_ - from);
+    len_ = (unsigned int)(write - buffer_) + len_ - from;
+    buffer_[len_] = '\0';
+    return;
+  }
+
+  // Growing, find every match first then fill from the back
+  std::vector<unsigned int> matches;
+  for (int at = indexOf(find); at >= 0; at = indexOf(find, at + find.len_)) {
+    matches.push_back(at);
+  }
+  if (matches.empty()) return;
+  unsigned int newlen = len_ + (unsigned int)matches.size() * (replace.len_ - find.len_);
+  if (!reserve(newlen)) return;
+  char* write = buffer_ + newlen;
+  unsigned int end = len_;
+  for (size_t i = matches.size(); i-- > 0;) {
+    unsigned int kept = end - (matches[i] + find.len_);
+    write -= kept;
+    ::memmove(write, buffer_ + matches[i] + find.len_, kept);
+    write -= replace.len_;
+    ::memcpy(write, replace.buffer_, replace.len_);
+    end = matches[i];
+  }
+  len_ = newlen;
+  buffer_[len_] = '\0';
+}
+
+void String::remove(unsigned int index) {
+  // Pass the biggest integer as the count, remove clamps it
+  remove(index, (unsigned int)-1);
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+  if (index >= len_) return;
+  if (count > len_ - index) count = len_ - index;
+  ::memmove(buffer_ + index, buffer_ + index + count, len_ - index - count);
+  len_ -= count;
+  buffer_[len_] = '\0';
+}
+
+void String::toLowerCase(void) {
+  for (unsigned int i = 0; i < len_; i++) {
+    buffer_[i] = (char)tolower((unsigned char)buffer_[i]);
+  }
+}
+
+void String::toUpperCase(void) {
+  for (unsigned int i = 0; i < len_; i++) {
+    buffer_[i] = (char)toupper((unsigned char)buffer_[i]);
+  }
+}
+
+void String::trim(void) {
+  if (!buffer_ || len_ == 0) return;
+  char* begin = buffer_;
+  while (isspace((unsigned char)*begin)) begin++;
+  char* end = buffer_ + len_ - 1;
+  while (isspace((unsigned char)*end) && end >= begin) end--;
+  len_ = (unsigned int)(end + 1 - begin);
+  if (begin > buffer_) ::memmove(buffer_, begin, len_);
+  buffer_[len_] = '\0';
+}
+
+// parsing/conversion
+
+long String::toInt(void) const {
+  if (buffer_) return atol(buffer_);
+  return 0;
+}
+
+float String::toFloat(void) const {
+  return float(toDouble());
+}
+
+double String::toDouble(void) const {
+  if (buffer_) return atof(buffer_);
+  return 0;
+}
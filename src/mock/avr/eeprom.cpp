@@ -1,26 +1,249 @@
 #include <avr/eeprom.h>
 
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace avr {
 namespace mock {
 size_t size = 0;
-std::unique_ptr<uint8_t[]> buffer;
+Buffer buffer;
+Counters writes;
+
+Release::Release(const size_t& mapped) : mapped(mapped) {
+}
+
+void Release::operator()(uint8_t* pointer) const {
+  if (mapped > 0) {
+#ifdef _WIN32
+    ::UnmapViewOfFile(pointer);
+#else
+    ::munmap(pointer, mapped);
+#endif
+  } else {
+    delete[] pointer;
+  }
+}
+
 void initialize(const size_t& size) {
   ::avr::mock::size = size;
-  buffer = std::make_unique<uint8_t[]>(size);
+  buffer = Buffer(new uint8_t[size](), Release());
+  writes.assign(size, 0);
 }
+
+bool initialize(const size_t& size, const char* path) {
+  uint8_t* pointer;
+  size_t existing;
+  release();
+  if (size == 0 || path == nullptr) {
+    return false;
+  }
+#ifdef _WIN32
+  HANDLE file = ::CreateFileA(
+    path,
+    GENERIC_READ | GENERIC_WRITE,
+    FILE_SHARE_READ | FILE_SHARE_WRITE,
+    NULL,
+    OPEN_ALWAYS,
+    FILE_ATTRIBUTE_NORMAL,
+    NULL);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  LARGE_INTEGER length;
+  if (!::GetFileSizeEx(file, &length)) {
+    ::CloseHandle(file);
+    return false;
+  }
+  existing = static_cast<size_t>(length.QuadPart);
+  HANDLE mapping = ::CreateFileMappingA(
+    file,
+    NULL,
+    PAGE_READWRITE,
+    static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+    static_cast<DWORD>(size & 0xffffffff),
+    NULL);
+  ::CloseHandle(file);
+  if (mapping == NULL) {
+    return false;
+  }
+  pointer = static_cast<uint8_t*>(
+    ::MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size));
+  /* The view keeps the mapping alive */
+  ::CloseHandle(mapping);
+  if (pointer == NULL) {
+    return false;
+  }
+#else
+  int descriptor = ::open(path, O_RDWR | O_CREAT, 0644);
+  if (descriptor < 0) {
+    return false;
+  }
+  struct stat status;
+  if (::fstat(descriptor, &status) != 0) {
+    ::close(descriptor);
+    return false;
+  }
+  existing = static_cast<size_t>(status.st_size);
+  if (existing < size && ::ftruncate(descriptor, size) != 0) {
+    ::close(descriptor);
+    return false;
+  }
+  void* mapped = ::mmap(
+    nullptr,
+    size,
+    PROT_READ | PROT_WRITE,
+    MAP_SHARED,
+    descriptor,
+    0);
+  /* The mapping keeps the file open */
+  ::close(descriptor);
+  if (mapped == MAP_FAILED) {
+    return false;
+  }
+  pointer = static_cast<uint8_t*>(mapped);
+#endif
+  if (existing < size) {
+    ::memset(pointer + existing, 0xff, size - existing);
+  }
+  ::avr::mock::size = size;
+  buffer = Buffer(pointer, Release(size));
+  writes.assign(size, 0);
+  return true;
+}
+
+void sync() {
+  if (buffer && buffer.get_deleter().mapped > 0) {
+#ifdef _WIN32
+    ::FlushViewOfFile(buffer.get(), size);
+#else
+    ::msync(buffer.get(), size, MS_SYNC);
+#endif
+  }
 }
+
+void release() {
+  buffer.reset();
+  writes.clear();
+  size = 0;
+}
+
+void reset() {
+  std::fill(writes.begin(), writes.end(), 0);
+}
+
+uint64_t cycles() {
+  uint64_t result = 0;
+  for (Counters::const_iterator it = writes.begin(); it != writes.end(); ++it) {
+    result += *it;
+  }
+  return result;
+}
+
+uint64_t nanoseconds() {
+  return cycles() * AVR_EEPROM_MOCK_WRITE_NANOSECONDS;
+}
+
+Cells hottest(const size_t& count) {
+  Cells cells;
+  cells.reserve(writes.size());
+  for (size_t i = 0; i < writes.size(); i++) {
+    if (writes[i] > 0) {
+      Cell cell = { i, writes[i] };
+      cells.push_back(cell);
+    }
+  }
+  size_t n = std::min(count, cells.size());
+  std::partial_sort(
+    cells.begin(),
+    cells.begin() + n,
+    cells.end(),
+    [](const Cell& a, const Cell& b) {
+      return a.writes > b.writes ||
+        (a.writes == b.writes && a.address < b.address);
+    });
+  cells.resize(n);
+  return cells;
+}
+
+size_t worn() {
+  return static_cast<size_t>(std::count_if(
+    writes.begin(),
+    writes.end(),
+    [](const uint32_t& count) { return count > AVR_EEPROM_MOCK_ENDURANCE; }));
+}
+}
+}
+
+/* Image location of count bytes at EEPROM address, throws when the mock
+   is not initialized or the range is out of bounds */
+static uint8_t* locate(const void* address, const size_t& count) {
+  size_t index = reinterpret_cast<size_t>(address);
+  if (
+    ::avr::mock::buffer &&
+    index < ::avr::mock::size &&
+    count <= ::avr::mock::size - index) {
+    return ::avr::mock::buffer.get() + index;
+  } else {
+    throw ::avr::mock::AvrMockException();
+  }
+}
+
+/* Erase and write count cells starting at the image location */
+static void program(uint8_t* cell, const uint8_t* source, const size_t& count) {
+  size_t index = static_cast<size_t>(cell - ::avr::mock::buffer.get());
+  ::memcpy(cell, source, count);
+  for (size_t i = 0; i < count; i++) {
+    ::avr::mock::writes[index + i]++;
+  }
 }
 
 /** \ingroup avr_eeprom
     Read one byte from EEPROM address \a __p.
   */
 uint8_t eeprom_read_byte(const uint8_t* __p) {
-  size_t index = reinterpret_cast<size_t>(__p);
-  if (::avr::mock::buffer && index < ::avr::mock::size) {
-    return ::avr::mock::buffer[index];
-  } else {
-    throw ::avr::mock::AvrMockException();
-  }
+  return *locate(__p, 1);
+}
+
+/** \ingroup avr_eeprom
+    Read one 16-bit word (little endian) from EEPROM address \a __p.
+  */
+uint16_t eeprom_read_word(const uint16_t* __p) {
+  const uint8_t* pointer = locate(__p, 2);
+  return static_cast<uint16_t>(pointer[0]) |
+    (static_cast<uint16_t>(pointer[1]) << 8);
+}
+
+/** \ingroup avr_eeprom
+    Read one 32-bit double word (little endian) from EEPROM address \a __p.
+  */
+uint32_t eeprom_read_dword(const uint32_t* __p) {
+  const uint8_t* pointer = locate(__p, 4);
+  return static_cast<uint32_t>(pointer[0]) |
+    (static_cast<uint32_t>(pointer[1]) << 8) |
+    (static_cast<uint32_t>(pointer[2]) << 16) |
+    (static_cast<uint32_t>(pointer[3]) << 24);
+}
+
+/** \ingroup avr_eeprom
+    Read one float value (little endian) from EEPROM address \a __p.
+  */
+float eeprom_read_float(const float* __p) {
+  float value;
+  uint32_t dword = eeprom_read_dword(reinterpret_cast<const uint32_t*>(__p));
+  ::memcpy(&value, &dword, sizeof(value));
+  return value;
 }
 
 /** \ingroup avr_eeprom
@@ -28,18 +251,7 @@ uint8_t eeprom_read_byte(const uint8_t* __p) {
     \a __dst.
   */
 void eeprom_read_block(void* __dst, const void* __src, size_t __n) {
-  size_t index = reinterpret_cast<size_t>(__src);
-  if (
-    ::avr::mock::buffer &&
-    index < ::avr::mock::size &&
-    index + __n < ::avr::mock::size) {
-    ::memcpy(
-      __dst,
-      static_cast<const void*>(::avr::mock::buffer.get() + index),
-      __n);
-  } else {
-    throw ::avr::mock::AvrMockException();
-  }
+  ::memcpy(__dst, locate(__src, __n), __n);
 }
 
 
@@ -47,12 +259,37 @@ void eeprom_read_block(void* __dst, const void* __src, size_t __n) {
     Write a byte \a __value to EEPROM address \a __p.
   */
 void eeprom_write_byte(uint8_t* __p, uint8_t __value) {
-  size_t index = reinterpret_cast<size_t>(__p);
-  if (::avr::mock::buffer && index < ::avr::mock::size) {
-    ::avr::mock::buffer[index] = __value;
-  } else {
-    throw ::avr::mock::AvrMockException();
+  program(locate(__p, 1), &__value, 1);
+}
+
+/** \ingroup avr_eeprom
+    Write a word \a __value to EEPROM address \a __p.
+  */
+void eeprom_write_word(uint16_t* __p, uint16_t __value) {
+  uint8_t bytes[2];
+  bytes[0] = static_cast<uint8_t>(__value & 0xff);
+  bytes[1] = static_cast<uint8_t>(__value >> 8);
+  program(locate(__p, 2), bytes, sizeof(bytes));
+}
+
+/** \ingroup avr_eeprom
+    Write a 32-bit double word \a __value to EEPROM address \a __p.
+  */
+void eeprom_write_dword(uint32_t* __p, uint32_t __value) {
+  uint8_t bytes[4];
+  for (uint8_t i = 0; i < 4; i++) {
+    bytes[i] = static_cast<uint8_t>((__value >> (8 * i)) & 0xff);
   }
+  program(locate(__p, 4), bytes, sizeof(bytes));
+}
+
+/** \ingroup avr_eeprom
+    Write a float \a __value to EEPROM address \a __p.
+  */
+void eeprom_write_float(float* __p, float __value) {
+  uint32_t dword;
+  ::memcpy(&dword, &__value, sizeof(dword));
+  eeprom_write_dword(reinterpret_cast<uint32_t*>(__p), dword);
 }
 
 /** \ingroup avr_eeprom
@@ -60,11 +297,75 @@ void eeprom_write_byte(uint8_t* __p, uint8_t __value) {
     \note The argument order is mismatch with common functions like strcpy().
   */
 void eeprom_write_block(const void* __src, void* __dst, size_t __n) {
-  size_t index = reinterpret_cast<size_t>(__dst);
-  if (
-    ::avr::mock::buffer &&
-    index < ::avr::mock::size &&
-    index + __n < ::avr::mock::size) {
-    ::memcpy(__dst, __src, __n);
+  program(locate(__dst, __n), static_cast<const uint8_t*>(__src), __n);
+}
+
+
+/** \ingroup avr_eeprom
+    Update a byte \a __value to EEPROM address \a __p.
+  */
+void eeprom_update_byte(uint8_t* __p, uint8_t __value) {
+  uint8_t* pointer = locate(__p, 1);
+  if (*pointer != __value) {
+    program(pointer, &__value, 1);
+  }
+}
+
+/** \ingroup avr_eeprom
+    Update a word \a __value to EEPROM address \a __p.
+  */
+void eeprom_update_word(uint16_t* __p, uint16_t __value) {
+  uint8_t bytes[2];
+  bytes[0] = static_cast<uint8_t>(__value & 0xff);
+  bytes[1] = static_cast<uint8_t>(__value >> 8);
+  eeprom_update_block(bytes, __p, sizeof(bytes));
+}
+
+/** \ingroup avr_eeprom
+    Update a 32-bit double word \a __value to EEPROM address \a __p.
+  */
+void eeprom_update_dword(uint32_t* __p, uint32_t __value) {
+  uint8_t bytes[4];
+  for (uint8_t i = 0; i < 4; i++) {
+    bytes[i] = static_cast<uint8_t>((__value >> (8 * i)) & 0xff);
+  }
+  eeprom_update_block(bytes, __p, sizeof(bytes));
+}
+
+/** \ingroup avr_eeprom
+    Update a float \a __value to EEPROM address \a __p.
+  */
+void eeprom_update_float(float* __p, float __value) {
+  uint32_t dword;
+  ::memcpy(&dword, &__value, sizeof(dword));
+  eeprom_update_dword(reinterpret_cast<uint32_t*>(__p), dword);
+}
+
+/** \ingroup avr_eeprom
+    Update a block of \a __n bytes to EEPROM address \a __dst from \a __src.
+    \note The argument order is mismatch with common functions like strcpy().
+    The mock compares eight bytes at a time and only writes the bytes
+    that differ.
+  */
+void eeprom_update_block(const void* __src, void* __dst, size_t __n) {
+  uint8_t* destination = locate(__dst, __n);
+  const uint8_t* source = static_cast<const uint8_t*>(__src);
+  uint64_t current, updated;
+  size_t i = 0;
+  for (; i + sizeof(updated) <= __n; i += sizeof(updated)) {
+    ::memcpy(&current, destination + i, sizeof(current));
+    ::memcpy(&updated, source + i, sizeof(updated));
+    if (current != updated) {
+      for (size_t j = i; j < i + sizeof(updated); j++) {
+        if (destination[j] != source[j]) {
+          program(destination + j, source + j, 1);
+        }
+      }
+    }
+  }
+  for (; i < __n; i++) {
+    if (destination[i] != source[i]) {
+      program(destination + i, source + i, 1);
+    }
   }
 }
@@ -0,0 +1,125 @@
+#include <algorithm>
+
+#include <gos/utils/bits.h>
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace utils {
+
+namespace bits {
+static const size_t Width = 64;
+
+static size_t words(const size_t& count) {
+  return (count + Width - 1) / Width;
+}
+
+static uint64_t mask(const size_t& count) {
+  return count >= Width ?
+    ~static_cast<uint64_t>(0) : (static_cast<uint64_t>(1) << count) - 1;
+}
+}
+
+Bits::Bits(const size_t& count) :
+  words_(bits::words(count), 0),
+  count_(count) {
+}
+
+size_t Bits::size() const {
+  return count_;
+}
+
+void Bits::resize(const size_t& count) {
+  if (count < count_ && count % bits::Width != 0) {
+    /* Clear the bits past the new end so a later grow reads zero */
+    words_[count / bits::Width] &= bits::mask(count % bits::Width);
+  }
+  words_.resize(bits::words(count), 0);
+  count_ = count;
+}
+
+void Bits::fill(const bool& value) {
+  std::fill(words_.begin(), words_.end(), value ? ~static_cast<uint64_t>(0) : 0);
+  if (value && count_ % bits::Width != 0) {
+    words_.back() &= bits::mask(count_ % bits::Width);
+  }
+}
+
+bool Bits::get(const size_t& index) const {
+  return (words_[index / bits::Width] >> (index % bits::Width)) & 1;
+}
+
+void Bits::set(const size_t& index, const bool& value) {
+  uint64_t bit = static_cast<uint64_t>(1) << (index % bits::Width);
+  if (value) {
+    words_[index / bits::Width] |= bit;
+  } else {
+    words_[index / bits::Width] &= ~bit;
+  }
+}
+
+bool Bits::operator[](const size_t& index) const {
+  return get(index);
+}
+
+void Bits::pack(uint8_t* destination, size_t index, size_t count) const {
+  while (count > 0) {
+    size_t taken = std::min(count, bits::Width);
+    uint64_t value = extract(index) & bits::mask(taken);
+    size_t bytes = (taken + 7) / 8;
+    for (size_t i = 0; i < bytes; i++) {
+      destination[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+    destination += bytes;
+    index += taken;
+    count -= taken;
+  }
+}
+
+void Bits::unpack(const uint8_t* source, size_t index, size_t count) {
+  while (count > 0) {
+    size_t taken = std::min(count, bits::Width);
+    size_t bytes = (taken + 7) / 8;
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+      value |= static_cast<uint64_t>(source[i]) << (8 * i);
+    }
+    insert(index, value, bits::mask(taken));
+    source += bytes;
+    index += taken;
+    count -= taken;
+  }
+}
+
+uint64_t Bits::extract(const size_t& index) const {
+  size_t word = index / bits::Width;
+  size_t shift = index % bits::Width;
+  if (word >= words_.size()) {
+    return 0;
+  }
+  uint64_t value = words_[word] >> shift;
+  if (shift > 0 && word + 1 < words_.size()) {
+    value |= words_[word + 1] << (bits::Width - shift);
+  }
+  return value;
+}
+
+void Bits::insert(
+  const size_t& index,
+  const uint64_t& value,
+  const uint64_t& mask) {
+  size_t word = index / bits::Width;
+  size_t shift = index % bits::Width;
+  words_[word] = (words_[word] & ~(mask << shift)) |
+    ((value & mask) << shift);
+  if (shift > 0 && word + 1 < words_.size()) {
+    size_t back = bits::Width - shift;
+    words_[word + 1] = (words_[word + 1] & ~(mask >> back)) |
+      ((value & mask) >> back);
+  }
+}
+
+}
+}
+}
+}
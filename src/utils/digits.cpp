@@ -0,0 +1,108 @@
+#include <gos/utils/digits.h>
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace utils {
+namespace digits {
+
+static const char Pairs[201] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+
+static const char Upper[37] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+static const char Lower[37] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+static char* decimal(uint64_t value, char* end) {
+  while (value >= 100) {
+    const char* pair = Pairs + 2 * (value % 100);
+    value /= 100;
+    *--end = pair[1];
+    *--end = pair[0];
+  }
+  if (value >= 10) {
+    *--end = Pairs[2 * value + 1];
+    *--end = Pairs[2 * value];
+  } else {
+    *--end = static_cast<char>('0' + value);
+  }
+  return end;
+}
+
+static char* power(
+  uint64_t value,
+  char* end,
+  const uint8_t& shift,
+  const char* symbols) {
+  const uint64_t mask = (static_cast<uint64_t>(1) << shift) - 1;
+  do {
+    *--end = symbols[value & mask];
+    value >>= shift;
+  } while (value);
+  return end;
+}
+
+static char* generic(
+  uint64_t value,
+  char* end,
+  const uint8_t& base,
+  const char* symbols) {
+  do {
+    *--end = symbols[value % base];
+    value /= base;
+  } while (value);
+  return end;
+}
+
+char* format(
+  const uint64_t& value,
+  char* end,
+  const uint8_t& base,
+  const bool& upper) {
+  const char* symbols = upper ? Upper : Lower;
+  switch (base) {
+  case 2:
+    return power(value, end, 1, symbols);
+  case 4:
+    return power(value, end, 2, symbols);
+  case 8:
+    return power(value, end, 3, symbols);
+  case 16:
+    return power(value, end, 4, symbols);
+  case 32:
+    return power(value, end, 5, symbols);
+  default:
+    if (base < 2 || base > 36 || base == 10) {
+      return decimal(value, end);
+    }
+    return generic(value, end, base, symbols);
+  }
+}
+
+char* formatsigned(
+  const int64_t& value,
+  char* end,
+  const uint8_t& base,
+  const bool& upper) {
+  if (value >= 0) {
+    return format(static_cast<uint64_t>(value), end, base, upper);
+  }
+  char* first = format(
+    static_cast<uint64_t>(0) - static_cast<uint64_t>(value), end, base, upper);
+  *--first = '-';
+  return first;
+}
+
+}
+}
+}
+}
+}
@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <cstring>
+
+#include <gos/utils/heap.h>
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace utils {
+
+namespace heap {
+/* The free list needs two bytes in every chunk */
+static const size_t Minimum = GOS_ARDUINO_TESTING_HEAP_HEADER + 2;
+
+static size_t total(const size_t& size) {
+  return std::max(size + GOS_ARDUINO_TESTING_HEAP_HEADER, Minimum);
+}
+}
+
+Heap::Heap(const size_t& size) :
+  Allocations(0),
+  Failures(0),
+  memory_(std::min(size, static_cast<size_t>(GOS_ARDUINO_TESTING_HEAP_LIMIT))),
+  break_(0),
+  used_(0),
+  peak_(0) {
+}
+
+void* Heap::allocate(const size_t& size) {
+  /* Also keeps the total from wrapping around */
+  if (size >= memory_.size()) {
+    Failures++;
+    return nullptr;
+  }
+  size_t needed = heap::total(size);
+
+  /* An exact fit, else the smallest chunk that is large enough */
+  std::map<size_t, size_t>::iterator best = free_.end();
+  for (std::map<size_t, size_t>::iterator it = free_.begin();
+    it != free_.end(); ++it) {
+    if (it->second >= needed &&
+      (best == free_.end() || it->second < best->second)) {
+      best = it;
+      if (it->second == needed) {
+        break;
+      }
+    }
+  }
+  if (best != free_.end()) {
+    size_t at = best->first;
+    size_t available = best->second;
+    free_.erase(best);
+    if (available - needed >= heap::Minimum) {
+      free_[at + needed] = available - needed;
+    } else {
+      needed = available;
+    }
+    Allocations++;
+    return place(at, needed);
+  }
+
+  if (break_ + needed > memory_.size()) {
+    Failures++;
+    return nullptr;
+  }
+  size_t at = break_;
+  break_ += needed;
+  peak_ = std::max(peak_, break_);
+  Allocations++;
+  return place(at, needed);
+}
+
+void* Heap::reallocate(void* pointer, const size_t& size) {
+  if (pointer == nullptr) {
+    return allocate(size);
+  }
+  if (size >= memory_.size()) {
+    Failures++;
+    return nullptr;
+  }
+  size_t at = offset(pointer);
+  size_t current = chunk(at);
+  size_t needed = heap::total(size);
+
+  if (needed <= current) {
+    if (current - needed >= heap::Minimum) {
+      used_ -= current;
+      place(at, needed);
+      free(at + needed, current - needed);
+    }
+    return pointer;
+  }
+
+  size_t next = at + current;
+  if (next == break_ && at + needed <= memory_.size()) {
+    break_ = at + needed;
+    peak_ = std::max(peak_, break_);
+    used_ -= current;
+    return place(at, needed);
+  }
+  std::map<size_t, size_t>::iterator it = free_.find(next);
+  if (it != free_.end() && current + it->second >= needed) {
+    size_t available = current + it->second;
+    free_.erase(it);
+    if (available - needed >= heap::Minimum) {
+      free_[at + needed] = available - needed;
+    } else {
+      needed = available;
+    }
+    used_ -= current;
+    return place(at, needed);
+  }
+
+  void* moved = allocate(size);
+  if (moved == nullptr) {
+    return nullptr;
+  }
+  ::memcpy(moved, pointer, current - GOS_ARDUINO_TESTING_HEAP_HEADER);
+  release(pointer);
+  return moved;
+}
+
+void Heap::release(void* pointer) {
+  if (pointer == nullptr) {
+    return;
+  }
+  size_t at = offset(pointer);
+  size_t current = chunk(at);
+  used_ -= current;
+  free(at, current);
+}
+
+bool Heap::owns(const void* pointer) const {
+  const uint8_t* byte = static_cast<const uint8_t*>(pointer);
+  return byte >= memory_.data() + GOS_ARDUINO_TESTING_HEAP_HEADER &&
+    byte < memory_.data() + memory_.size();
+}
+
+size_t Heap::size() const {
+  return memory_.size();
+}
+
+size_t Heap::used() const {
+  return used_;
+}
+
+size_t Heap::peak() const {
+  return peak_;
+}
+
+size_t Heap::largest() const {
+  size_t result = memory_.size() - break_;
+  for (std::map<size_t, size_t>::const_iterator it = free_.begin();
+    it != free_.end(); ++it) {
+    result = std::max(result, it->second);
+  }
+  return result > GOS_ARDUINO_TESTING_HEAP_HEADER ?
+    result - GOS_ARDUINO_TESTING_HEAP_HEADER : 0;
+}
+
+size_t Heap::offset(const void* pointer) const {
+  return static_cast<const uint8_t*>(pointer) - memory_.data() -
+    GOS_ARDUINO_TESTING_HEAP_HEADER;
+}
+
+size_t Heap::chunk(const size_t& offset) const {
+  uint16_t size;
+  ::memcpy(&size, memory_.data() + offset, sizeof(size));
+  return static_cast<size_t>(size) + GOS_ARDUINO_TESTING_HEAP_HEADER;
+}
+
+void* Heap::place(const size_t& offset, const size_t& size) {
+  uint16_t header = static_cast<uint16_t>(
+    size - GOS_ARDUINO_TESTING_HEAP_HEADER);
+  ::memcpy(memory_.data() + offset, &header, sizeof(header));
+  used_ += size;
+  return memory_.data() + offset + GOS_ARDUINO_TESTING_HEAP_HEADER;
+}
+
+void Heap::free(const size_t& offset, const size_t& size) {
+  size_t at = offset;
+  size_t length = size;
+
+  std::map<size_t, size_t>::iterator next = free_.find(at + length);
+  if (next != free_.end()) {
+    length += next->second;
+    free_.erase(next);
+  }
+  std::map<size_t, size_t>::iterator previous = free_.lower_bound(at);
+  if (previous != free_.begin()) {
+    --previous;
+    if (previous->first + previous->second == at) {
+      at = previous->first;
+      length += previous->second;
+      free_.erase(previous);
+    }
+  }
+
+  if (at + length == break_) {
+    /* The top chunk goes back below the break as avr-libc free does */
+    break_ = at;
+  } else {
+    free_[at] = length;
+  }
+}
+
+}
+}
+}
+}
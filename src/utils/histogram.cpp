@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <limits>
+
+#include <gos/utils/histogram.h>
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace utils {
+
+namespace histogram {
+static uint8_t msb(uint64_t value) {
+  uint8_t result = 0;
+  for (uint8_t shift = 32; shift > 0; shift >>= 1) {
+    if (value >> shift) {
+      value >>= shift;
+      result += shift;
+    }
+  }
+  return result;
+}
+}
+
+Histogram::Histogram(const uint8_t& significant) :
+  significant_(std::max<uint8_t>(1, std::min<uint8_t>(significant, 16))),
+  count_(0),
+  minimum_(std::numeric_limits<uint64_t>::max()),
+  maximum_(0),
+  sum_(0.0) {
+  counts_.resize(index(std::numeric_limits<uint64_t>::max()) + 1, 0);
+}
+
+void Histogram::record(const uint64_t& value, const uint64_t& count) {
+  counts_[index(value)] += count;
+  count_ += count;
+  minimum_ = std::min(minimum_, value);
+  maximum_ = std::max(maximum_, value);
+  sum_ += static_cast<double>(value) * static_cast<double>(count);
+}
+
+void Histogram::clear() {
+  std::fill(counts_.begin(), counts_.end(), 0);
+  count_ = 0;
+  minimum_ = std::numeric_limits<uint64_t>::max();
+  maximum_ = 0;
+  sum_ = 0.0;
+}
+
+uint64_t Histogram::count() const {
+  return count_;
+}
+
+uint64_t Histogram::minimum() const {
+  return count_ > 0 ? minimum_ : 0;
+}
+
+uint64_t Histogram::maximum() const {
+  return maximum_;
+}
+
+double Histogram::mean() const {
+  return count_ > 0 ? sum_ / static_cast<double>(count_) : 0.0;
+}
+
+uint64_t Histogram::percentile(const double& percent) const {
+  if (count_ == 0) {
+    return 0;
+  }
+  double clamped = std::max(0.0, std::min(percent, 100.0));
+  uint64_t target = static_cast<uint64_t>(
+    clamped / 100.0 * static_cast<double>(count_) + 0.5);
+  target = std::max<uint64_t>(target, 1);
+  uint64_t accumulated = 0;
+  for (size_t i = 0; i < counts_.size(); i++) {
+    accumulated += counts_[i];
+    if (accumulated >= target) {
+      return std::max(minimum_, std::min(highest(i), maximum_));
+    }
+  }
+  return maximum_;
+}
+
+void Histogram::report(std::ostream& stream, const char* unit) const {
+  stream << "count " << count_
+    << " mean " << mean() << unit
+    << " min " << minimum() << unit
+    << " p50 " << percentile(50.0) << unit
+    << " p90 " << percentile(90.0) << unit
+    << " p99 " << percentile(99.0) << unit
+    << " p99.9 " << percentile(99.9) << unit
+    << " max " << maximum() << unit;
+}
+
+size_t Histogram::index(const uint64_t& value) const {
+  if (value < (static_cast<uint64_t>(1) << significant_)) {
+    return static_cast<size_t>(value);
+  }
+  uint8_t shift = histogram::msb(value) - significant_ + 1;
+  return (static_cast<size_t>(shift) << (significant_ - 1)) +
+    static_cast<size_t>(value >> shift);
+}
+
+uint64_t Histogram::highest(const size_t& index) const {
+  if (index < (static_cast<size_t>(1) << significant_)) {
+    return static_cast<uint64_t>(index);
+  }
+  size_t shift = (index >> (significant_ - 1)) - 1;
+  uint64_t mantissa = static_cast<uint64_t>(index - (shift << (significant_ - 1)));
+  return (mantissa << shift) + ((static_cast<uint64_t>(1) << shift) - 1);
+}
+
+}
+}
+}
+}
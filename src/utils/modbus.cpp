@@ -0,0 +1,278 @@
+#include <cstring>
+
+#include <gos/utils/crc.h>
+#include <gos/utils/modbus.h>
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace utils {
+namespace modbus {
+
+typedef crc::Modbus<> Crc;
+
+namespace master {
+
+static size_t seal(uint8_t* frame, size_t length) {
+  uint16_t crc = Crc::calculate(frame, length);
+  frame[length++] = static_cast<uint8_t>(crc & 0xff);
+  frame[length++] = static_cast<uint8_t>(crc >> 8);
+  return length;
+}
+
+static void put(uint8_t* frame, const uint16_t& word) {
+  frame[0] = static_cast<uint8_t>(word >> 8);
+  frame[1] = static_cast<uint8_t>(word & 0xff);
+}
+
+static uint16_t get(const uint8_t* frame) {
+  return static_cast<uint16_t>(frame[0]) << 8 | frame[1];
+}
+
+size_t read(
+  uint8_t* frame,
+  const uint8_t& id,
+  const uint8_t& function,
+  const uint16_t& address,
+  const uint16_t& count) {
+  frame[0] = id;
+  frame[1] = function;
+  put(frame + 2, address);
+  put(frame + 4, count);
+  return seal(frame, 6);
+}
+
+size_t write(
+  uint8_t* frame,
+  const uint8_t& id,
+  const uint16_t& address,
+  const uint16_t* values,
+  const uint16_t& count) {
+  frame[0] = id;
+  frame[1] = 0x10;
+  put(frame + 2, address);
+  put(frame + 4, count);
+  frame[6] = static_cast<uint8_t>(2 * count);
+  for (uint16_t i = 0; i < count; i++) {
+    put(frame + 7 + 2 * i, values[i]);
+  }
+  return seal(frame, 7 + 2 * static_cast<size_t>(count));
+}
+
+size_t expected(const uint8_t* request, const size_t& length) {
+  if (length < 4 || request[0] == 0) {
+    return 0;
+  } else if (request[1] == 0x07) {
+    /* Read exception status carries no address or count */
+    return 5;
+  } else if (length < 6) {
+    return 0;
+  }
+  uint16_t count = get(request + 4);
+  switch (request[1]) {
+  case 0x01:
+  case 0x02:
+    return 5 + (static_cast<size_t>(count) + 7) / 8;
+  case 0x03:
+  case 0x04:
+    return 5 + 2 * static_cast<size_t>(count);
+  default:
+    return 8;
+  }
+}
+
+bool valid(const uint8_t* frame, const size_t& length) {
+  return length >= 4 && Crc::calculate(frame, length - 2) ==
+    (frame[length - 2] | static_cast<uint16_t>(frame[length - 1]) << 8);
+}
+
+bool exception(const uint8_t* frame, const size_t& length) {
+  return length >= 2 && (frame[1] & 0x80) != 0;
+}
+
+}
+
+namespace tcp {
+
+size_t wrap(
+  uint8_t* adu,
+  const uint16_t& transaction,
+  const uint8_t* frame,
+  const size_t& length) {
+  /* The unit is the last header byte, the CRC is not carried */
+  size_t carried = length - 2;
+  master::put(adu, transaction);
+  master::put(adu + 2, 0);
+  master::put(adu + 4, static_cast<uint16_t>(carried));
+  ::memcpy(adu + GOS_ARDUINO_TESTING_MODBUS_MBAP_SIZE - 1, frame, carried);
+  return GOS_ARDUINO_TESTING_MODBUS_MBAP_SIZE - 1 + carried;
+}
+
+size_t unwrap(uint8_t* frame, const uint8_t* adu, const size_t& length) {
+  size_t carried = length - (GOS_ARDUINO_TESTING_MODBUS_MBAP_SIZE - 1);
+  ::memcpy(frame, adu + GOS_ARDUINO_TESTING_MODBUS_MBAP_SIZE - 1, carried);
+  return master::seal(frame, carried);
+}
+
+size_t expected(const uint8_t* adu, const size_t& length) {
+  if (length < GOS_ARDUINO_TESTING_MODBUS_MBAP_SIZE - 1) {
+    return 0;
+  }
+  return GOS_ARDUINO_TESTING_MODBUS_MBAP_SIZE - 1 + master::get(adu + 4);
+}
+
+uint16_t transaction(const uint8_t* adu) {
+  return master::get(adu);
+}
+
+}
+
+Generator::Generator(const Mix& mix) :
+  mix_(mix),
+  sequence_(0),
+  offset_(0) {
+  if (mix_.Window < mix_.Count) {
+    mix_.Window = mix_.Count;
+  }
+}
+
+size_t Generator::next(uint8_t* frame) {
+  uint32_t total = static_cast<uint32_t>(mix_.ReadCoils) +
+    mix_.ReadHolding + mix_.WriteMultiple;
+  uint32_t slot = total > 0 ? sequence_++ % total : 0;
+  uint16_t address = mix_.Address + offset_;
+  offset_ += mix_.Count;
+  if (offset_ + mix_.Count > mix_.Window) {
+    offset_ = 0;
+  }
+  if (slot < mix_.ReadCoils) {
+    return master::read(frame, mix_.Id, 0x01, address, mix_.Count);
+  } else if (slot < static_cast<uint32_t>(mix_.ReadCoils) + mix_.ReadHolding) {
+    return master::read(frame, mix_.Id, 0x03, address, mix_.Count);
+  } else {
+    uint16_t values[GOS_ARDUINO_TESTING_MODBUS_FRAME_SIZE / 2];
+    uint16_t count = mix_.Count > 123 ? 123 : mix_.Count;
+    for (uint16_t i = 0; i < count; i++) {
+      values[i] = static_cast<uint16_t>(sequence_ + i);
+    }
+    return master::write(frame, mix_.Id, address, values, count);
+  }
+}
+
+Session::Session(const size_t& depth) :
+  depth_(depth),
+  transaction_(0) {
+}
+
+size_t Session::request(
+  uint8_t* adu,
+  Generator& generator,
+  const uint64_t& time) {
+  if (pending_.size() >= depth_) {
+    return 0;
+  }
+  uint8_t frame[GOS_ARDUINO_TESTING_MODBUS_FRAME_SIZE];
+  size_t length = generator.next(frame);
+  /* Skip identifiers still outstanding after a wrap */
+  while (pending_.count(transaction_) > 0) {
+    transaction_++;
+  }
+  pending_[transaction_] = time;
+  return tcp::wrap(adu, transaction_++, frame, length);
+}
+
+bool Session::response(
+  const uint8_t* adu,
+  const size_t& length,
+  const uint64_t& time,
+  Load& load) {
+  if (length < GOS_ARDUINO_TESTING_MODBUS_MBAP_SIZE ||
+    length > GOS_ARDUINO_TESTING_MODBUS_ADU_SIZE) {
+    load.Invalid++;
+    return false;
+  }
+  std::map<uint16_t, uint64_t>::iterator it =
+    pending_.find(tcp::transaction(adu));
+  if (it == pending_.end()) {
+    return false;
+  }
+  if (master::get(adu + 2) != 0 || tcp::expected(adu, length) != length) {
+    load.Invalid++;
+    return false;
+  }
+  uint8_t frame[GOS_ARDUINO_TESTING_MODBUS_FRAME_SIZE];
+  size_t framelength = tcp::unwrap(frame, adu, length);
+  load.response(frame, framelength, time - it->second);
+  pending_.erase(it);
+  return true;
+}
+
+size_t Session::outstanding() const {
+  return pending_.size();
+}
+
+Load::Load() :
+  Requests(0),
+  Responses(0),
+  Exceptions(0),
+  Invalid(0),
+  Timeouts(0),
+  BytesSent(0),
+  BytesReceived(0),
+  Elapsed(0) {
+}
+
+void Load::request(const size_t& bytes) {
+  Requests++;
+  BytesSent += bytes;
+}
+
+void Load::response(
+  const uint8_t* frame,
+  const size_t& length,
+  const uint64_t& latency) {
+  BytesReceived += length;
+  if (!master::valid(frame, length)) {
+    Invalid++;
+    return;
+  }
+  Responses++;
+  if (master::exception(frame, length)) {
+    Exceptions++;
+  }
+  Latency.record(latency);
+}
+
+void Load::timeout() {
+  Timeouts++;
+}
+
+double Load::throughput() const {
+  return Elapsed > 0 ?
+    1.0e6 * static_cast<double>(Responses) / static_cast<double>(Elapsed) :
+    0.0;
+}
+
+double Load::exceptionrate() const {
+  return Responses > 0 ?
+    static_cast<double>(Exceptions) / static_cast<double>(Responses) : 0.0;
+}
+
+void Load::report(std::ostream& stream) const {
+  stream << "requests " << Requests
+    << " responses " << Responses
+    << " exceptions " << Exceptions
+    << " invalid " << Invalid
+    << " timeouts " << Timeouts
+    << " throughput " << throughput() << "/s"
+    << " exception rate " << exceptionrate() << std::endl
+    << "latency ";
+  Latency.report(stream, "us");
+  stream << std::endl;
+}
+
+}
+}
+}
+}
+}
@@ -1,3 +1,5 @@
+#include <cstring>
+
 #include <gos/utils/order.h>
 
 namespace gos {
@@ -41,6 +43,72 @@ uint8_t fyrstbyte(const uint16_t& word, const Order& order) {
 uint8_t secondbyte(const uint16_t& word, const Order& order) {
   return fyrstbyte(word, contrary(order));
 }
+Order host() {
+  const uint16_t probe = 0x0102;
+  uint8_t first;
+  ::memcpy(&first, &probe, 1);
+  return first == 0x02 ? Order::LittleEndian : Order::BigEndian;
+}
+
+static void swap(uint8_t* destination, const uint8_t* source, const size_t& count) {
+  size_t i = 0;
+  uint64_t lane;
+  for (; i + sizeof(lane) <= count; i += sizeof(lane)) {
+    ::memcpy(&lane, source + i, sizeof(lane));
+    lane = ((lane >> 8) & 0x00ff00ff00ff00ffULL) |
+      ((lane & 0x00ff00ff00ff00ffULL) << 8);
+    ::memcpy(destination + i, &lane, sizeof(lane));
+  }
+  for (; i + 1 < count; i += 2) {
+    uint8_t first = source[i];
+    destination[i] = source[i + 1];
+    destination[i + 1] = first;
+  }
+}
+
+void store(uint8_t* destination, const uint16_t* words, const size_t& count, const Order& order) {
+  if (order == host()) {
+    ::memcpy(destination, words, 2 * count);
+  } else {
+    swap(destination, reinterpret_cast<const uint8_t*>(words), 2 * count);
+  }
+}
+
+void load(uint16_t* words, const uint8_t* source, const size_t& count, const Order& order) {
+  if (order == host()) {
+    ::memcpy(words, source, 2 * count);
+  } else {
+    swap(reinterpret_cast<uint8_t*>(words), source, 2 * count);
+  }
+}
+}
+
+namespace bit {
+uint8_t reverse(const uint8_t& value) {
+  uint8_t result = value;
+  result = ((result >> 1) & 0x55) | ((result & 0x55) << 1);
+  result = ((result >> 2) & 0x33) | ((result & 0x33) << 2);
+  result = (result >> 4) | (result << 4);
+  return result;
+}
+
+void reverse(uint8_t* data, const size_t& count) {
+  size_t i = 0;
+  uint64_t lane;
+  for (; i + sizeof(lane) <= count; i += sizeof(lane)) {
+    ::memcpy(&lane, data + i, sizeof(lane));
+    lane = ((lane >> 1) & 0x5555555555555555ULL) |
+      ((lane & 0x5555555555555555ULL) << 1);
+    lane = ((lane >> 2) & 0x3333333333333333ULL) |
+      ((lane & 0x3333333333333333ULL) << 2);
+    lane = ((lane >> 4) & 0x0f0f0f0f0f0f0f0fULL) |
+      ((lane & 0x0f0f0f0f0f0f0f0fULL) << 4);
+    ::memcpy(data + i, &lane, sizeof(lane));
+  }
+  for (; i < count; i++) {
+    data[i] = reverse(data[i]);
+  }
+}
 }
 
 }
@@ -0,0 +1,125 @@
+#include <algorithm>
+
+#include <gos/utils/rtu.h>
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace utils {
+namespace rtu {
+
+Timing::Timing(const uint32_t& rate, const uint8_t& bits) :
+  Character(rate > 0 ? (1000000UL * bits + rate - 1) / rate : 0) {
+  if (rate > 19200) {
+    Interchar = 750;
+    Interframe = 1750;
+  } else {
+    Interchar = (3 * Character + 1) / 2;
+    Interframe = (7 * Character + 1) / 2;
+  }
+}
+
+Clock::Clock() : Now(0) {
+}
+
+unsigned long Clock::micros() const {
+  return static_cast<unsigned long>(Now);
+}
+
+void Clock::advance(const uint64_t& microseconds) {
+  Now += microseconds;
+}
+
+void Clock::until(const uint64_t& time) {
+  Now = std::max(Now, time);
+}
+
+Line::Line(Clock& clock, const uint32_t& rate) :
+  Sent(0),
+  Received(0),
+  clock_(clock),
+  timing_(rate),
+  last_(0),
+  idle_(0) {
+}
+
+void Line::send(const uint8_t* data, const size_t& count) {
+  if (count == 0) {
+    return;
+  }
+  /* The first character is on the wire one character time after now */
+  Burst burst;
+  burst.start = std::max(clock_.Now, idle_) + timing_.Character;
+  burst.count = count;
+  bursts_.push_back(burst);
+  bytes_.pushbytes(data, count);
+  idle_ = burst.start + (count - 1) * timing_.Character;
+  Sent += count;
+}
+
+size_t Line::available() const {
+  size_t result = 0;
+  for (std::deque<Burst>::const_iterator it = bursts_.begin();
+    it != bursts_.end(); ++it) {
+    if (it->start > clock_.Now) {
+      break;
+    }
+    size_t arrived = static_cast<size_t>(
+      (clock_.Now - it->start) / timing_.Character) + 1;
+    if (arrived < it->count) {
+      return result + arrived;
+    }
+    result += it->count;
+  }
+  return result;
+}
+
+size_t Line::read(uint8_t* data, const size_t& count) {
+  size_t wanted = std::min(count, available());
+  size_t remaining = wanted;
+  while (remaining > 0) {
+    Burst& burst = bursts_.front();
+    size_t taken = std::min(remaining, burst.count);
+    last_ = arrival(burst, taken - 1);
+    if (taken == burst.count) {
+      bursts_.pop_front();
+    } else {
+      burst.start = arrival(burst, taken);
+      burst.count -= taken;
+    }
+    remaining -= taken;
+  }
+  bytes_.popbytes(data, wanted);
+  Received += wanted;
+  return wanted;
+}
+
+uint64_t Line::last() const {
+  return last_;
+}
+
+uint64_t Line::next() const {
+  return bursts_.empty() ? idle_ : bursts_.front().start;
+}
+
+uint64_t Line::idle() const {
+  return idle_;
+}
+
+Clock& Line::clock() const {
+  return clock_;
+}
+
+const Timing& Line::timing() const {
+  return timing_;
+}
+
+uint64_t Line::arrival(const Burst& burst, const size_t& index) const {
+  return burst.start + index * timing_.Character;
+}
+
+}
+}
+}
+}
+}
@@ -0,0 +1,124 @@
+#include <cerrno>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <gos/utils/sink.h>
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace utils {
+
+BufferSink::BufferSink(const size_t& capacity) {
+  buffer_.reserve(capacity);
+}
+
+size_t BufferSink::write(const uint8_t* data, const size_t& size) {
+  buffer_.insert(buffer_.end(), data, data + size);
+  return size;
+}
+
+const uint8_t* BufferSink::data() const {
+  return buffer_.data();
+}
+
+size_t BufferSink::size() const {
+  return buffer_.size();
+}
+
+std::string BufferSink::str() const {
+  return std::string(buffer_.begin(), buffer_.end());
+}
+
+void BufferSink::clear() {
+  buffer_.clear();
+}
+
+RingSink::RingSink(const size_t& capacity) :
+  Overwritten(0),
+  buffer_(capacity > 0 ? capacity : 1),
+  head_(0),
+  count_(0) {
+}
+
+size_t RingSink::write(const uint8_t* data, const size_t& size) {
+  size_t capacity = buffer_.size();
+  size_t count = size;
+  if (count > capacity) {
+    /* Only the tail of the span survives */
+    Overwritten += count_ + count - capacity;
+    data += count - capacity;
+    count = capacity;
+    head_ = 0;
+    count_ = 0;
+  } else if (count_ + count > capacity) {
+    size_t dropped = count_ + count - capacity;
+    Overwritten += dropped;
+    head_ = (head_ + dropped) % capacity;
+    count_ -= dropped;
+  }
+
+  size_t tail = (head_ + count_) % capacity;
+  size_t first = count < capacity - tail ? count : capacity - tail;
+  ::memcpy(buffer_.data() + tail, data, first);
+  ::memcpy(buffer_.data(), data + first, count - first);
+  count_ += count;
+  return size;
+}
+
+size_t RingSink::size() const {
+  return count_;
+}
+
+size_t RingSink::capacity() const {
+  return buffer_.size();
+}
+
+std::string RingSink::str() const {
+  size_t first = count_ < buffer_.size() - head_ ?
+    count_ : buffer_.size() - head_;
+  std::string result(
+    reinterpret_cast<const char*>(buffer_.data() + head_), first);
+  result.append(
+    reinterpret_cast<const char*>(buffer_.data()), count_ - first);
+  return result;
+}
+
+void RingSink::clear() {
+  head_ = 0;
+  count_ = 0;
+}
+
+DescriptorSink::DescriptorSink(const int& descriptor) :
+  descriptor_(descriptor) {
+}
+
+size_t DescriptorSink::write(const uint8_t* data, const size_t& size) {
+  size_t written = 0;
+  while (written < size) {
+#ifdef _WIN32
+    int result = ::_write(descriptor_, data + written,
+      static_cast<unsigned int>(size - written));
+#else
+    ssize_t result = ::write(descriptor_, data + written, size - written);
+#endif
+    if (result < 0 && errno == EINTR) {
+      continue;
+    }
+    if (result <= 0) {
+      break;
+    }
+    written += static_cast<size_t>(result);
+  }
+  return written;
+}
+
+}
+}
+}
+}
@@ -0,0 +1,229 @@
+#include <gos/utils/spidevice.h>
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace utils {
+namespace spi {
+
+Device::Device(const bit::Order& order, const uint8_t& modes) :
+  BitOrder(order),
+  Modes(modes) {
+}
+
+Device::~Device() {
+}
+
+void Device::select() {
+}
+
+void Device::deselect() {
+}
+
+void Device::transfer(uint8_t* buffer, const size_t& count) {
+  for (size_t i = 0; i < count; i++) {
+    buffer[i] = transfer(buffer[i]);
+  }
+}
+
+/* MAX31865 */
+
+/* Data is latched on the rising edge in mode 1 and mode 3 */
+Max31865::Max31865() :
+  Device(bit::Order::MsbFirst, 0x0a),
+  addressed_(false),
+  write_(false),
+  address_(0) {
+  for (uint8_t i = 0; i < RegisterCount; i++) {
+    Registers[i] = 0x00;
+  }
+  Registers[HighFaultMsb] = 0xff;
+  Registers[HighFaultLsb] = 0xff;
+}
+
+void Max31865::rtd(const uint16_t& raw, const bool& fault) {
+  Registers[RtdMsb] = static_cast<uint8_t>((raw >> 7) & 0xff);
+  Registers[RtdLsb] = static_cast<uint8_t>(((raw & 0x7f) << 1) | (fault ? 1 : 0));
+}
+
+void Max31865::fault(const uint8_t& status) {
+  Registers[FaultStatus] = status;
+  Registers[RtdLsb] = (Registers[RtdLsb] & 0xfe) | (status ? 1 : 0);
+}
+
+void Max31865::select() {
+  addressed_ = false;
+}
+
+uint8_t Max31865::transfer(const uint8_t& mosi) {
+  if (!addressed_) {
+    addressed_ = true;
+    write_ = (mosi & 0x80) != 0;
+    address_ = mosi & 0x7f;
+    return 0x00;
+  }
+  uint8_t index = address_ & (RegisterCount - 1);
+  address_++;
+  if (write_) {
+    switch (index) {
+    case Configuration:
+      /* The one-shot and fault status clear bits clear themselves */
+      if (mosi & 0x02) {
+        Registers[FaultStatus] = 0x00;
+      }
+      Registers[Configuration] = mosi & 0xdd;
+      break;
+    case HighFaultMsb:
+    case HighFaultLsb:
+    case LowFaultMsb:
+    case LowFaultLsb:
+      Registers[index] = mosi;
+      break;
+    default:
+      /* Read only register */
+      break;
+    }
+    return 0x00;
+  } else {
+    return Registers[index];
+  }
+}
+
+/* MAX6675 */
+
+/* Data changes on the falling edge so mode 0 and mode 1 both read */
+Max6675::Max6675() :
+  Device(bit::Order::MsbFirst, 0x03),
+  Frame(0x0000),
+  latched_(0x0000),
+  index_(0) {
+}
+
+void Max6675::temperature(const double& celsius) {
+  double quarters = celsius * 4.0;
+  uint16_t code;
+  if (quarters <= 0.0) {
+    code = 0;
+  } else if (quarters >= 4095.0) {
+    code = 4095;
+  } else {
+    code = static_cast<uint16_t>(quarters);
+  }
+  Frame = (Frame & 0x0007) | static_cast<uint16_t>(code << 3);
+}
+
+void Max6675::open(const bool& open) {
+  if (open) {
+    Frame |= 0x0004;
+  } else {
+    Frame &= ~0x0004;
+  }
+}
+
+void Max6675::select() {
+  latched_ = Frame;
+  index_ = 0;
+}
+
+uint8_t Max6675::transfer(const uint8_t& /* mosi */) {
+  switch (index_++) {
+  case 0:
+    return static_cast<uint8_t>(latched_ >> 8);
+  case 1:
+    return static_cast<uint8_t>(latched_ & 0x00ff);
+  default:
+    index_ = 2;
+    return 0x00;
+  }
+}
+
+/* MCP3208 */
+
+namespace mcp3208 {
+namespace state {
+enum {
+  Idle,
+  Configuration,
+  Sample,
+  Null,
+  Msb,
+  Lsb,
+  Done
+};
+}
+}
+
+/* Mode 0,0 and mode 1,1 */
+Mcp3208::Mcp3208() :
+  Device(bit::Order::MsbFirst, 0x09),
+  state_(mcp3208::state::Idle),
+  configuration_(0),
+  count_(0),
+  value_(0) {
+  for (uint8_t i = 0; i < ChannelCount; i++) {
+    Single[i] = 0;
+    Differential[i] = 0;
+  }
+}
+
+void Mcp3208::select() {
+  state_ = mcp3208::state::Idle;
+}
+
+uint8_t Mcp3208::transfer(const uint8_t& mosi) {
+  uint8_t miso = 0x00;
+  for (int8_t i = 7; i >= 0; i--) {
+    miso = (miso << 1) | shift((mosi >> i) & 0x01);
+  }
+  return miso;
+}
+
+uint8_t Mcp3208::shift(const uint8_t& mosi) {
+  uint8_t miso = 0;
+  switch (state_) {
+  case mcp3208::state::Idle:
+    if (mosi) {
+      configuration_ = 0;
+      count_ = 0;
+      state_ = mcp3208::state::Configuration;
+    }
+    break;
+  case mcp3208::state::Configuration:
+    configuration_ = (configuration_ << 1) | mosi;
+    if (++count_ == 4) {
+      uint8_t channel = configuration_ & (ChannelCount - 1);
+      value_ = (configuration_ & 0x08 ? Single : Differential)[channel] & 0x0fff;
+      state_ = mcp3208::state::Sample;
+    }
+    break;
+  case mcp3208::state::Sample:
+    state_ = mcp3208::state::Null;
+    break;
+  case mcp3208::state::Null:
+    count_ = 12;
+    state_ = mcp3208::state::Msb;
+    break;
+  case mcp3208::state::Msb:
+    miso = (value_ >> --count_) & 0x01;
+    if (count_ == 0) {
+      count_ = 1;
+      state_ = mcp3208::state::Lsb;
+    }
+    break;
+  case mcp3208::state::Lsb:
+    miso = (value_ >> count_++) & 0x01;
+    if (count_ == 12) {
+      state_ = mcp3208::state::Done;
+    }
+    break;
+  default:
+    break;
+  }
+  return miso;
+}
+
+}
+}
+}
+}
+}
@@ -1,3 +1,7 @@
+#include <cstring>
+
+#include <algorithm>
+
 #include <gos/utils/wordq.h>
 
 namespace gatub = ::gos::arduino::testing::utils::byte;
@@ -7,59 +11,112 @@ namespace arduino {
 namespace testing {
 namespace utils {
 
-WordQueue::WordQueue(const byte::Order& order)
-  : order_(order) {
+static size_t roundup(const size_t& value) {
+  size_t result = 1;
+  while (result < value) {
+    result <<= 1;
+  }
+  return result;
+}
+
+WordQueue::WordQueue(const byte::Order& order, const size_t& capacity)
+  : capacity_(roundup(capacity > 2 ? capacity : 2)),
+  head_(0),
+  count_(0),
+  order_(order) {
+  buffer_ = std::make_unique<uint8_t[]>(capacity_);
 }
 
-size_t WordQueue::bytes() {
-  return queue_.size();
+size_t WordQueue::bytes() const {
+  return count_;
 }
 
-size_t WordQueue::words() {
+size_t WordQueue::words() const {
   return bytes() / 2;
 }
 
+size_t WordQueue::capacity() const {
+  return capacity_;
+}
+
+byte::Order WordQueue::order() const {
+  return order_;
+}
+
 void WordQueue::pushbyte(const uint8_t& byte) {
-  queue_.push(byte);
+  ensure(1);
+  buffer_[tail()] = byte;
+  count_++;
 }
 
 void WordQueue::pushbytes(const uint8_t* bytes, const size_t& count) {
-  for (size_t i = 0; i < count; i++) {
-    pushbyte(bytes[i]);
+  ensure(count);
+  size_t position = tail();
+  size_t first = std::min(count, capacity_ - position);
+  ::memcpy(buffer_.get() + position, bytes, first);
+  if (first < count) {
+    ::memcpy(buffer_.get(), bytes + first, count - first);
   }
+  count_ += count;
 }
 
 void WordQueue::pushword(const uint16_t& word) {
-  uint8_t byte;
-  byte = gatub::fyrstbyte(word, order_);
-  queue_.push(byte);
-  byte = gatub::secondbyte(word, order_);
-  queue_.push(byte);
+  ensure(2);
+  size_t mask = capacity_ - 1;
+  size_t position = tail();
+  buffer_[position] = gatub::fyrstbyte(word, order_);
+  buffer_[(position + 1) & mask] = gatub::secondbyte(word, order_);
+  count_ += 2;
 }
 
 void WordQueue::pushwords(const uint16_t* words, const size_t& count) {
-  for (size_t i = 0; i < count; i++) {
-    pushword(words[i]);
+  ensure(2 * count);
+  size_t mask = capacity_ - 1;
+  size_t position = tail();
+  uint8_t* buffer = buffer_.get();
+  if (position + 2 * count <= capacity_) {
+    /* Contiguous, swizzle straight into the ring */
+    uint8_t* pointer = buffer + position;
+    if (order_ == byte::Order::LittleEndian) {
+      for (size_t i = 0; i < count; i++) {
+        *(pointer++) = static_cast<uint8_t>(words[i] & 0x00ff);
+        *(pointer++) = static_cast<uint8_t>(words[i] >> 8);
+      }
+    } else {
+      for (size_t i = 0; i < count; i++) {
+        *(pointer++) = gatub::fyrstbyte(words[i], order_);
+        *(pointer++) = gatub::secondbyte(words[i], order_);
+      }
+    }
+  } else {
+    for (size_t i = 0; i < count; i++) {
+      buffer[position] = gatub::fyrstbyte(words[i], order_);
+      position = (position + 1) & mask;
+      buffer[position] = gatub::secondbyte(words[i], order_);
+      position = (position + 1) & mask;
+    }
   }
+  count_ += 2 * count;
 }
 
 bool WordQueue::popbyte(uint8_t& value) {
-  if (queue_.size() > 0) {
-    value = queue_.front();
-    queue_.pop();
+  if (count_ > 0) {
+    value = buffer_[head_];
+    head_ = (head_ + 1) & (capacity_ - 1);
+    count_--;
     return true;
   } else {
     return false;
   }
 }
- 
-bool WordQueue::popword(uint16_t& value) {
 
-  if (queue_.size() > 1) {
-    uint8_t first = queue_.front();
-    queue_.pop();
-    uint8_t second = queue_.front();
-    queue_.pop();
+bool WordQueue::popword(uint16_t& value) {
+  if (count_ > 1) {
+    size_t mask = capacity_ - 1;
+    uint8_t first = buffer_[head_];
+    uint8_t second = buffer_[(head_ + 1) & mask];
+    head_ = (head_ + 2) & mask;
+    count_ -= 2;
     value = gatub::combine(first, second, order_);
     return true;
   } else {
@@ -67,9 +124,113 @@ bool WordQueue::popword(uint16_t& value) {
   }
 }
 
+size_t WordQueue::popbytes(uint8_t* data, const size_t& count) {
+  size_t result = std::min(count, count_);
+  size_t first = std::min(result, capacity_ - head_);
+  ::memcpy(data, buffer_.get() + head_, first);
+  if (first < result) {
+    ::memcpy(data + first, buffer_.get(), result - first);
+  }
+  head_ = (head_ + result) & (capacity_ - 1);
+  count_ -= result;
+  return result;
+}
+
+size_t WordQueue::popwords(uint16_t* words, const size_t& count) {
+  size_t result = std::min(count, count_ / 2);
+  size_t mask = capacity_ - 1;
+  size_t position = head_;
+  const uint8_t* buffer = buffer_.get();
+  for (size_t i = 0; i < result; i++) {
+    uint8_t first = buffer[position];
+    position = (position + 1) & mask;
+    uint8_t second = buffer[position];
+    position = (position + 1) & mask;
+    words[i] = gatub::combine(first, second, order_);
+  }
+  head_ = position;
+  count_ -= 2 * result;
+  return result;
+}
+
+size_t WordQueue::drop(const size_t& count) {
+  size_t result = std::min(count, count_);
+  head_ = (head_ + result) & (capacity_ - 1);
+  count_ -= result;
+  return result;
+}
+
+Span WordQueue::peek() {
+  linearize();
+  Span span;
+  span.data = buffer_.get() + head_;
+  span.size = count_;
+  return span;
+}
+
+void WordQueue::peek(Span& first, Span& second) const {
+  size_t contiguous = std::min(count_, capacity_ - head_);
+  first.data = buffer_.get() + head_;
+  first.size = contiguous;
+  second.data = buffer_.get();
+  second.size = count_ - contiguous;
+}
+
+uint8_t* WordQueue::prepare(const size_t& count) {
+  ensure(count);
+  size_t position = tail();
+  if (position >= head_ && capacity_ - position < count) {
+    /* The free space wraps, move the content to the start of the ring */
+    ::memmove(buffer_.get(), buffer_.get() + head_, count_);
+    head_ = 0;
+    position = count_;
+  }
+  return buffer_.get() + position;
+}
+
+void WordQueue::commit(const size_t& count) {
+  count_ += count;
+}
+
+void WordQueue::reserve(const size_t& capacity) {
+  if (capacity > capacity_) {
+    size_t updated = roundup(capacity);
+    Buffer buffer = std::make_unique<uint8_t[]>(updated);
+    /* Drain into the start of the new ring and restore the count */
+    size_t count = popbytes(buffer.get(), count_);
+    head_ = 0;
+    count_ = count;
+    buffer_ = std::move(buffer);
+    capacity_ = updated;
+  }
+}
+
 void WordQueue::clear() {
-  while (!queue_.empty()) {
-    queue_.pop();
+  head_ = 0;
+  count_ = 0;
+}
+
+size_t WordQueue::tail() const {
+  return (head_ + count_) & (capacity_ - 1);
+}
+
+void WordQueue::ensure(const size_t& count) {
+  if (count_ + count > capacity_) {
+    size_t capacity = capacity_;
+    while (count_ + count > capacity) {
+      capacity <<= 1;
+    }
+    reserve(capacity);
+  }
+}
+
+void WordQueue::linearize() {
+  if (head_ + count_ > capacity_) {
+    std::rotate(
+      buffer_.get(),
+      buffer_.get() + head_,
+      buffer_.get() + capacity_);
+    head_ = 0;
   }
 }
 
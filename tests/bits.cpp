@@ -0,0 +1,85 @@
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gos/utils/bits.h>
+
+namespace gatu = ::gos::arduino::testing::utils;
+
+TEST(BitsTest, Access) {
+  gatu::Bits bits(130);
+  EXPECT_EQ(130, bits.size());
+  EXPECT_FALSE(bits[129]);
+  bits.set(0, true);
+  bits.set(64, true);
+  bits.set(129, true);
+  EXPECT_TRUE(bits[0]);
+  EXPECT_TRUE(bits.get(64));
+  EXPECT_TRUE(bits[129]);
+  EXPECT_FALSE(bits[63]);
+  bits.set(64, false);
+  EXPECT_FALSE(bits[64]);
+
+  bits.fill(true);
+  EXPECT_TRUE(bits[128]);
+  bits.resize(100);
+  bits.resize(200);
+  EXPECT_TRUE(bits[99]);
+  EXPECT_FALSE(bits[100]);
+  EXPECT_FALSE(bits[199]);
+}
+
+TEST(BitsTest, Pack) {
+  /* Modbus example, coils 20 to 38 are CD 6B 05 */
+  const uint8_t coils[] = { 0xcd, 0x6b, 0x05 };
+  gatu::Bits bits(64);
+  uint8_t packed[3];
+  bits.unpack(coils, 19, 19);
+  EXPECT_TRUE(bits[19]);
+  EXPECT_FALSE(bits[20]);
+  EXPECT_TRUE(bits[37]);
+  EXPECT_FALSE(bits[38]);
+  bits.pack(packed, 19, 19);
+  EXPECT_EQ(0xcd, packed[0]);
+  EXPECT_EQ(0x6b, packed[1]);
+  EXPECT_EQ(0x05, packed[2]);
+}
+
+TEST(BitsTest, Ranges) {
+  const size_t size = 2100;
+  gatu::Bits bits(size);
+  std::vector<bool> reference(size, false);
+  std::vector<uint8_t> buffer(size / 8 + 2);
+  uint32_t state = 11u;
+
+  for (int round = 0; round < 200; round++) {
+    state = state * 1103515245u + 12345u;
+    size_t index = (state >> 8) % size;
+    state = state * 1103515245u + 12345u;
+    size_t count = 1 + (state >> 8) % (size - index);
+    for (size_t i = 0; i < (count + 7) / 8; i++) {
+      state = state * 1103515245u + 12345u;
+      buffer[i] = static_cast<uint8_t>(state >> 16);
+    }
+    bits.unpack(buffer.data(), index, count);
+    for (size_t i = 0; i < count; i++) {
+      reference[index + i] = (buffer[i / 8] >> (i % 8)) & 1;
+    }
+
+    state = state * 1103515245u + 12345u;
+    index = (state >> 8) % size;
+    state = state * 1103515245u + 12345u;
+    count = 1 + (state >> 8) % (size - index);
+    bits.pack(buffer.data(), index, count);
+    for (size_t i = 0; i < count; i++) {
+      ASSERT_EQ(reference[index + i], ((buffer[i / 8] >> (i % 8)) & 1) != 0);
+    }
+    /* Padding bits of the last byte are zero */
+    if (count % 8) {
+      EXPECT_EQ(0, buffer[count / 8] >> (count % 8));
+    }
+  }
+  for (size_t i = 0; i < size; i++) {
+    ASSERT_EQ(reference[i], bits[i]);
+  }
+}
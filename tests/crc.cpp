@@ -0,0 +1,133 @@
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gos/utils/crc.h>
+
+#define CRC_CHECK_TEXT "123456789"
+#define CRC_BENCHMARK_SIZE 0x100000
+#define CRC_BENCHMARK_ROUNDS 4
+
+namespace gatuc = ::gos::arduino::testing::utils::crc;
+namespace gatucp = ::gos::arduino::testing::utils::crc::policy;
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace crc {
+
+/* Deterministic pseudo random content */
+static void fill(std::vector<uint8_t>& data) {
+  uint32_t state = 11u;
+  for (size_t i = 0; i < data.size(); i++) {
+    state = state * 1103515245u + 12345u;
+    data[i] = static_cast<uint8_t>(state >> 16);
+  }
+}
+
+template<typename E> double throughput(
+  const std::vector<uint8_t>& data,
+  typename E::Type& result) {
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+  for (int i = 0; i < CRC_BENCHMARK_ROUNDS; i++) {
+    result = E::calculate(data.data(), data.size());
+  }
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+  return CRC_BENCHMARK_ROUNDS * data.size() / elapsed.count() / 1.0e6;
+}
+
+}
+}
+}
+}
+
+namespace gatc = ::gos::arduino::testing::crc;
+
+TEST(CrcTest, Check) {
+  const size_t size = sizeof(CRC_CHECK_TEXT) - 1;
+  EXPECT_EQ(0xcbf43926, gatuc::Crc32<gatucp::Bitwise>::calculate(
+    CRC_CHECK_TEXT, size));
+  EXPECT_EQ(0xcbf43926, gatuc::Crc32<gatucp::Table>::calculate(
+    CRC_CHECK_TEXT, size));
+  EXPECT_EQ(0xcbf43926, gatuc::Crc32<gatucp::Slicing>::calculate(
+    CRC_CHECK_TEXT, size));
+  EXPECT_EQ(0x4b37, gatuc::Modbus<gatucp::Bitwise>::calculate(
+    CRC_CHECK_TEXT, size));
+  EXPECT_EQ(0x4b37, gatuc::Modbus<gatucp::Table>::calculate(
+    CRC_CHECK_TEXT, size));
+  EXPECT_EQ(0x4b37, gatuc::Modbus<gatucp::Slicing>::calculate(
+    CRC_CHECK_TEXT, size));
+}
+
+TEST(CrcTest, Modbus) {
+  const uint8_t framea[] = { 0x01, 0x01, 0x00, 0x00, 0x00, 0x01 };
+  const uint8_t frameb[] = { 0x01, 0x01, 0x01, 0x00 };
+  EXPECT_EQ(0xcafd, gatuc::Modbus<>::calculate(framea, sizeof(framea)));
+  EXPECT_EQ(0x8851, gatuc::Modbus<>::calculate(frameb, sizeof(frameb)));
+  EXPECT_EQ(0xcafd, gatuc::Modbus<gatucp::Slicing>::calculate(
+    framea, sizeof(framea)));
+}
+
+TEST(CrcTest, Policy) {
+  std::vector<uint8_t> data(1027);
+  gatc::fill(data);
+  /* Every length so the slicing tail and the table path are covered */
+  for (size_t size = 0; size < 64; size++) {
+    uint32_t bitwise = gatuc::Crc32<gatucp::Bitwise>::calculate(
+      data.data(), size);
+    EXPECT_EQ(bitwise, gatuc::Crc32<gatucp::Table>::calculate(
+      data.data(), size));
+    EXPECT_EQ(bitwise, gatuc::Crc32<gatucp::Slicing>::calculate(
+      data.data(), size));
+    uint16_t modbus = gatuc::Modbus<gatucp::Bitwise>::calculate(
+      data.data(), size);
+    EXPECT_EQ(modbus, gatuc::Modbus<gatucp::Table>::calculate(
+      data.data(), size));
+    EXPECT_EQ(modbus, gatuc::Modbus<gatucp::Slicing>::calculate(
+      data.data(), size));
+  }
+
+  /* Incremental update over misaligned pieces */
+  typedef gatuc::Crc32<gatucp::Slicing> Slicing;
+  uint32_t crc = Slicing::initial();
+  crc = Slicing::update(crc, data.data(), 13);
+  crc = Slicing::update(crc, data.data() + 13, data.size() - 13);
+  EXPECT_EQ(
+    gatuc::Crc32<gatucp::Bitwise>::calculate(data.data(), data.size()),
+    Slicing::finalize(crc));
+}
+
+TEST(CrcTest, Benchmark) {
+  std::vector<uint8_t> data(CRC_BENCHMARK_SIZE);
+  gatc::fill(data);
+
+  uint32_t bitwise, table, slicing;
+  double bitwiserate = gatc::throughput<gatuc::Crc32<gatucp::Bitwise>>(
+    data, bitwise);
+  double tablerate = gatc::throughput<gatuc::Crc32<gatucp::Table>>(
+    data, table);
+  double slicingrate = gatc::throughput<gatuc::Crc32<gatucp::Slicing>>(
+    data, slicing);
+  EXPECT_EQ(bitwise, table);
+  EXPECT_EQ(bitwise, slicing);
+  std::cout << "CRC-32 MB/s bitwise " << bitwiserate
+    << " table " << tablerate
+    << " slicing-by-8 " << slicingrate << std::endl;
+
+  uint16_t mbitwise, mtable, mslicing;
+  bitwiserate = gatc::throughput<gatuc::Modbus<gatucp::Bitwise>>(
+    data, mbitwise);
+  tablerate = gatc::throughput<gatuc::Modbus<gatucp::Table>>(
+    data, mtable);
+  slicingrate = gatc::throughput<gatuc::Modbus<gatucp::Slicing>>(
+    data, mslicing);
+  EXPECT_EQ(mbitwise, mtable);
+  EXPECT_EQ(mbitwise, mslicing);
+  std::cout << "Modbus CRC-16 MB/s bitwise " << bitwiserate
+    << " table " << tablerate
+    << " slicing-by-8 " << slicingrate << std::endl;
+}
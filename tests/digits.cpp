@@ -0,0 +1,137 @@
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gos/utils/digits.h>
+#include <gos/utils/lcg.h>
+
+#define DIGITS_SWEEP_COUNT 100000
+#define DIGITS_BENCHMARK_COUNT 10000
+#define DIGITS_BENCHMARK_ROUNDS 50
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace digits {
+
+/* The digit at a time division printNumber used before */
+static char* reference(uint64_t value, char* end, uint8_t base) {
+  if (base < 2) base = 10;
+  do {
+    char c = static_cast<char>(value % base);
+    value /= base;
+    *--end = c < 10 ? c + '0' : c + 'A' - 10;
+  } while (value);
+  return end;
+}
+
+static std::string text(const char* first, const char* end) {
+  return std::string(first, end - first);
+}
+
+}
+}
+}
+}
+
+namespace gatd = ::gos::arduino::testing::digits;
+namespace gatud = ::gos::arduino::testing::utils::digits;
+namespace gatul = ::gos::arduino::testing::utils::lcg;
+
+TEST(DigitsTest, Format) {
+  char buffer[GOS_ARDUINO_TESTING_DIGITS_BUFFER];
+  char* end = buffer + sizeof(buffer);
+
+  EXPECT_EQ("0", gatd::text(gatud::format(0, end), end));
+  EXPECT_EQ("9", gatd::text(gatud::format(9, end), end));
+  EXPECT_EQ("10", gatd::text(gatud::format(10, end), end));
+  EXPECT_EQ("18446744073709551615",
+    gatd::text(gatud::format(UINT64_MAX, end), end));
+  EXPECT_EQ("FF", gatd::text(gatud::format(255, end, 16), end));
+  EXPECT_EQ("ff", gatd::text(gatud::format(255, end, 16, false), end));
+  EXPECT_EQ("377", gatd::text(gatud::format(255, end, 8), end));
+  EXPECT_EQ(std::string(64, '1'),
+    gatd::text(gatud::format(UINT64_MAX, end, 2), end));
+  EXPECT_EQ("ZZ", gatd::text(gatud::format(36 * 36 - 1, end, 36), end));
+  /* An unsupported base is decimal */
+  EXPECT_EQ("123", gatd::text(gatud::format(123, end, 1), end));
+  EXPECT_EQ("123", gatd::text(gatud::format(123, end, 37), end));
+
+  EXPECT_EQ("-42", gatd::text(gatud::formatsigned(-42, end), end));
+  EXPECT_EQ("-9223372036854775808",
+    gatd::text(gatud::formatsigned(INT64_MIN, end), end));
+  EXPECT_EQ("-2a", gatd::text(gatud::formatsigned(-42, end, 16, false), end));
+
+  char expected[GOS_ARDUINO_TESTING_DIGITS_BUFFER];
+  char* expectedend = expected + sizeof(expected);
+  const uint8_t bases[] = { 2, 3, 4, 7, 8, 10, 16, 32, 36 };
+  uint64_t state = 1;
+  size_t mismatches = 0;
+  for (int i = 0; i < DIGITS_SWEEP_COUNT; i++) {
+    /* Spread the values over every length */
+    uint64_t value = gatul::next(state) >> (i % 64);
+    uint8_t base = bases[i % sizeof(bases)];
+    if (gatd::text(gatud::format(value, end, base), end) !=
+      gatd::text(gatd::reference(value, expectedend, base), expectedend)) {
+      mismatches++;
+    }
+  }
+  EXPECT_EQ(0, mismatches);
+}
+
+TEST(DigitsTest, Benchmark) {
+  struct Range {
+    const char* name;
+    uint8_t base;
+    uint8_t shift;
+  };
+  const Range ranges[] = {
+    { "dec 1-2", 10, 57 },
+    { "dec 4-5", 10, 47 },
+    { "dec 9-10", 10, 32 },
+    { "dec 19-20", 10, 0 },
+    { "hex 16", 16, 0 },
+    { "oct 22", 8, 0 },
+    { "bin 64", 2, 0 } };
+
+  char buffer[GOS_ARDUINO_TESTING_DIGITS_BUFFER];
+  char* end = buffer + sizeof(buffer);
+  for (size_t r = 0; r < sizeof(ranges) / sizeof(ranges[0]); r++) {
+    std::vector<uint64_t> values(DIGITS_BENCHMARK_COUNT);
+    uint64_t state = 1;
+    for (size_t i = 0; i < values.size(); i++) {
+      values[i] = gatul::next(state) >> ranges[r].shift;
+    }
+
+    size_t engine = 0, division = 0;
+    std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+    for (int round = 0; round < DIGITS_BENCHMARK_ROUNDS; round++) {
+      for (size_t i = 0; i < values.size(); i++) {
+        engine += end - gatud::format(values[i], end, ranges[r].base);
+      }
+    }
+    std::chrono::duration<double> enginetime =
+      std::chrono::steady_clock::now() - start;
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < DIGITS_BENCHMARK_ROUNDS; round++) {
+      for (size_t i = 0; i < values.size(); i++) {
+        division += end - gatd::reference(values[i], end, ranges[r].base);
+      }
+    }
+    std::chrono::duration<double> divisiontime =
+      std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(division, engine);
+
+    double conversions = static_cast<double>(DIGITS_BENCHMARK_ROUNDS) *
+      values.size();
+    std::cout << ranges[r].name << " ns/conversion "
+      << 1.0e9 * enginetime.count() / conversions
+      << " division " << 1.0e9 * divisiontime.count() / conversions
+      << std::endl;
+  }
+}
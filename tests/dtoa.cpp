@@ -0,0 +1,144 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <avr/dtoa_conv.h>
+
+#include <gos/utils/lcg.h>
+
+#define DTOA_SWEEP_COUNT 200000
+#define DTOA_BENCHMARK_COUNT 10000
+#define DTOA_BENCHMARK_ROUNDS 20
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace dtoa {
+
+static double random(uint64_t& state) {
+  uint64_t bits = utils::lcg::next(state);
+  double value;
+  ::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/* Telemetry values, mostly within a few decades of one */
+static double reading(uint64_t& state) {
+  utils::lcg::next(state);
+  double scale = static_cast<double>(1ULL << ((state >> 59) & 0x1f));
+  return (static_cast<double>(state >> 11) / 9007199254740992.0 - 0.5) *
+    scale;
+}
+
+static std::string printf(
+  const double& value,
+  const unsigned char& width,
+  const unsigned char& prec,
+  const unsigned char& flags) {
+  std::string format = "%";
+  if (flags & DTOA_LEFT) format += "-";
+  if (flags & DTOA_PLUS) format += "+";
+  if (flags & DTOA_SPACE) format += " ";
+  if (flags & DTOA_ZFILL) format += "0";
+  format += "*.*f";
+  std::vector<char> text(1024);
+  ::snprintf(text.data(), text.size(), format.c_str(), width, prec, value);
+  return text.data();
+}
+
+}
+}
+}
+}
+
+namespace gatd = ::gos::arduino::testing::dtoa;
+
+TEST(DtoaTest, Printf) {
+  const double values[] = {
+    0.0, -0.0, 0.5, 1.5, 2.5, -2.5, 0.125, 0.0625, 1.0e-300, 4.9e-324,
+    123456789.123456789, -273.15, 1.0e15, 9007199254740993.0, 1.0e19,
+    1.8446744073709552e19, 1.0e22, 1.7976931348623157e308 };
+  char text[1024];
+  for (size_t v = 0; v < sizeof(values) / sizeof(values[0]); v++) {
+    for (unsigned char prec = 0; prec <= 24; prec++) {
+      dtoa_prf_d(values[v], text, 0, prec, 0);
+      EXPECT_EQ(gatd::printf(values[v], 0, prec, 0), text)
+        << values[v] << " " << static_cast<int>(prec);
+    }
+  }
+
+  const unsigned char flags[] = {
+    0, DTOA_LEFT, DTOA_PLUS, DTOA_SPACE, DTOA_ZFILL, DTOA_PLUS | DTOA_ZFILL };
+  uint64_t state = 1;
+  size_t mismatches = 0;
+  for (int i = 0; i < DTOA_SWEEP_COUNT; i++) {
+    double value = i % 2 ? gatd::random(state) : gatd::reading(state);
+    if (value != value) {
+      continue;
+    }
+    unsigned char prec = static_cast<unsigned char>(i % 12);
+    unsigned char width = static_cast<unsigned char>(i % 16);
+    unsigned char flag = flags[i % sizeof(flags)];
+    dtoa_prf_d(value, text, width, prec, flag);
+    if (gatd::printf(value, width, prec, flag) != text) {
+      mismatches++;
+    }
+  }
+  EXPECT_EQ(0, mismatches);
+
+  EXPECT_EQ(DTOA_NONFINITE, dtoa_prf_d(-1.0 / 0.0, text, 6, 2, DTOA_UPPER));
+  EXPECT_STREQ("  -INF", text);
+  EXPECT_EQ(DTOA_NONFINITE, dtoa_prf_d(0.0 / 0.0, text, 0, 2, DTOA_LEFT));
+  EXPECT_STREQ("nan", text);
+}
+
+TEST(DtoaTest, Precision) {
+  /* The float path keeps about seven significant digits */
+  char text[64];
+  dtoa_prf_f(static_cast<float>(1234567.891), text, 0, 3, 0);
+  EXPECT_STRNE("1234567.891", text);
+  dtoa_prf_d(1234567.891, text, 0, 3, 0);
+  EXPECT_STREQ("1234567.891", text);
+}
+
+TEST(DtoaTest, Benchmark) {
+  std::vector<double> values(DTOA_BENCHMARK_COUNT);
+  uint64_t state = 1;
+  for (size_t i = 0; i < values.size(); i++) {
+    values[i] = gatd::reading(state);
+  }
+
+  char text[1024];
+  size_t engine = 0, library = 0;
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+  for (int r = 0; r < DTOA_BENCHMARK_ROUNDS; r++) {
+    for (size_t i = 0; i < values.size(); i++) {
+      dtoa_prf_d(values[i], text, 0, 3, 0);
+      engine += text[0];
+    }
+  }
+  std::chrono::duration<double> enginetime =
+    std::chrono::steady_clock::now() - start;
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < DTOA_BENCHMARK_ROUNDS; r++) {
+    for (size_t i = 0; i < values.size(); i++) {
+      ::snprintf(text, sizeof(text), "%.3f", values[i]);
+      library += text[0];
+    }
+  }
+  std::chrono::duration<double> librarytime =
+    std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(library, engine);
+
+  double conversions = static_cast<double>(DTOA_BENCHMARK_ROUNDS) *
+    values.size();
+  std::cout << "dtoa_prf_d ns/conversion "
+    << 1.0e9 * enginetime.count() / conversions
+    << " snprintf " << 1.0e9 * librarytime.count() / conversions << std::endl;
+}
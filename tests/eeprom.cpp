@@ -0,0 +1,158 @@
+#include <cstdio>
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include <avr/eeprom.h>
+
+#define AVR_EEPROM_TEST_FILE "avreepromtest.bin"
+
+namespace am = ::avr::mock;
+
+TEST(AvrEepromTest, Heap) {
+  const size_t size = 1024;
+  am::initialize(size);
+  EXPECT_EQ(size, am::size);
+  EXPECT_EQ(0x00, eeprom_read_byte(reinterpret_cast<const uint8_t*>(10)));
+  eeprom_write_byte(reinterpret_cast<uint8_t*>(10), 0x5a);
+  EXPECT_EQ(0x5a, eeprom_read_byte(reinterpret_cast<const uint8_t*>(10)));
+  EXPECT_THROW(
+    eeprom_read_byte(reinterpret_cast<const uint8_t*>(size)),
+    am::AvrMockException);
+  am::release();
+  EXPECT_THROW(
+    eeprom_read_byte(reinterpret_cast<const uint8_t*>(10)),
+    am::AvrMockException);
+}
+
+TEST(AvrEepromTest, File) {
+  const size_t size = 4096;
+  bool result;
+  std::remove(AVR_EEPROM_TEST_FILE);
+
+  result = am::initialize(size, AVR_EEPROM_TEST_FILE);
+  ASSERT_TRUE(result);
+  /* A new image is erased */
+  EXPECT_EQ(0xff, eeprom_read_byte(reinterpret_cast<const uint8_t*>(0)));
+  EXPECT_EQ(0xff, eeprom_read_byte(
+    reinterpret_cast<const uint8_t*>(size - 1)));
+  eeprom_write_byte(reinterpret_cast<uint8_t*>(0), 0x93);
+  eeprom_write_byte(reinterpret_cast<uint8_t*>(size - 1), 0x66);
+  am::sync();
+  am::release();
+
+  /* Reopen and extend, the content survives and the extension is erased */
+  result = am::initialize(2 * size, AVR_EEPROM_TEST_FILE);
+  ASSERT_TRUE(result);
+  EXPECT_EQ(0x93, eeprom_read_byte(reinterpret_cast<const uint8_t*>(0)));
+  EXPECT_EQ(0x66, eeprom_read_byte(
+    reinterpret_cast<const uint8_t*>(size - 1)));
+  EXPECT_EQ(0xff, eeprom_read_byte(reinterpret_cast<const uint8_t*>(size)));
+  am::release();
+
+  std::remove(AVR_EEPROM_TEST_FILE);
+}
+
+TEST(AvrEepromTest, Access) {
+  const size_t size = 256;
+  uint8_t block[37], readblock[sizeof(block)];
+  am::initialize(size);
+
+  eeprom_write_word(reinterpret_cast<uint16_t*>(1), 0x1234);
+  EXPECT_EQ(0x34, eeprom_read_byte(reinterpret_cast<const uint8_t*>(1)));
+  EXPECT_EQ(0x12, eeprom_read_byte(reinterpret_cast<const uint8_t*>(2)));
+  EXPECT_EQ(0x1234, eeprom_read_word(reinterpret_cast<const uint16_t*>(1)));
+
+  eeprom_write_dword(reinterpret_cast<uint32_t*>(4), 0xdeadbeef);
+  EXPECT_EQ(0xef, eeprom_read_byte(reinterpret_cast<const uint8_t*>(4)));
+  EXPECT_EQ(0xdeadbeef, eeprom_read_dword(
+    reinterpret_cast<const uint32_t*>(4)));
+
+  eeprom_write_float(reinterpret_cast<float*>(8), 93.418F);
+  EXPECT_FLOAT_EQ(93.418F, eeprom_read_float(
+    reinterpret_cast<const float*>(8)));
+
+  eeprom_update_word(reinterpret_cast<uint16_t*>(12), 0xabcd);
+  EXPECT_EQ(0xabcd, eeprom_read_word(reinterpret_cast<const uint16_t*>(12)));
+  eeprom_update_dword(reinterpret_cast<uint32_t*>(16), 0x01020304);
+  EXPECT_EQ(0x01020304, eeprom_read_dword(
+    reinterpret_cast<const uint32_t*>(16)));
+  eeprom_update_float(reinterpret_cast<float*>(20), -6.66F);
+  EXPECT_FLOAT_EQ(-6.66F, eeprom_read_float(
+    reinterpret_cast<const float*>(20)));
+  eeprom_update_byte(reinterpret_cast<uint8_t*>(24), 0x42);
+  EXPECT_EQ(0x42, eeprom_read_byte(reinterpret_cast<const uint8_t*>(24)));
+
+  for (size_t i = 0; i < sizeof(block); i++) {
+    block[i] = static_cast<uint8_t>(3 * i);
+  }
+  eeprom_write_block(block, reinterpret_cast<void*>(size - sizeof(block)),
+    sizeof(block));
+  eeprom_read_block(readblock,
+    reinterpret_cast<const void*>(size - sizeof(block)), sizeof(block));
+  EXPECT_EQ(0, ::memcmp(block, readblock, sizeof(block)));
+
+  block[3] = 0x00;
+  block[sizeof(block) - 1] = 0x00;
+  eeprom_update_block(block, reinterpret_cast<void*>(100), sizeof(block));
+  eeprom_read_block(readblock, reinterpret_cast<const void*>(100),
+    sizeof(block));
+  EXPECT_EQ(0, ::memcmp(block, readblock, sizeof(block)));
+
+  EXPECT_THROW(
+    eeprom_write_block(block, reinterpret_cast<void*>(size - 1), 2),
+    am::AvrMockException);
+  EXPECT_THROW(
+    eeprom_read_dword(reinterpret_cast<const uint32_t*>(size - 2)),
+    am::AvrMockException);
+
+  am::release();
+}
+
+TEST(AvrEepromTest, Wear) {
+  const size_t size = 64;
+  uint8_t block[16];
+  am::Cells cells;
+  am::initialize(size);
+  for (size_t i = 0; i < sizeof(block); i++) {
+    block[i] = static_cast<uint8_t>(i);
+  }
+
+  /* Write always erases and writes while update skips unchanged cells */
+  for (int i = 0; i < 10; i++) {
+    eeprom_write_block(block, reinterpret_cast<void*>(0), sizeof(block));
+  }
+  EXPECT_EQ(10 * sizeof(block), am::cycles());
+  am::reset();
+  for (int i = 0; i < 10; i++) {
+    eeprom_update_block(block, reinterpret_cast<void*>(0), sizeof(block));
+  }
+  EXPECT_EQ(0, am::cycles());
+
+  block[5] = 0xff;
+  eeprom_update_block(block, reinterpret_cast<void*>(0), sizeof(block));
+  EXPECT_EQ(1, am::cycles());
+  EXPECT_EQ(1, am::writes[5]);
+
+  eeprom_write_word(reinterpret_cast<uint16_t*>(32), 0x1234);
+  eeprom_write_word(reinterpret_cast<uint16_t*>(32), 0x1234);
+  eeprom_update_word(reinterpret_cast<uint16_t*>(32), 0x1234);
+  eeprom_write_byte(reinterpret_cast<uint8_t*>(33), 0x00);
+  EXPECT_EQ(6, am::cycles());
+  EXPECT_EQ(6ULL * AVR_EEPROM_MOCK_WRITE_NANOSECONDS, am::nanoseconds());
+
+  cells = am::hottest(2);
+  ASSERT_EQ(2, cells.size());
+  EXPECT_EQ(33, cells[0].address);
+  EXPECT_EQ(3, cells[0].writes);
+  EXPECT_EQ(32, cells[1].address);
+  EXPECT_EQ(2, cells[1].writes);
+  EXPECT_EQ(3, am::hottest(10).size());
+  EXPECT_EQ(0, am::worn());
+
+  am::writes[7] = AVR_EEPROM_MOCK_ENDURANCE + 1;
+  EXPECT_EQ(1, am::worn());
+
+  am::release();
+  EXPECT_EQ(0, am::cycles());
+}
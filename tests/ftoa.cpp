@@ -0,0 +1,132 @@
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <avr/ftoa_engine.h>
+#include <avr/dtoa_conv.h>
+
+#define FTOA_SWEEP_COUNT 1000000
+#define FTOA_BENCHMARK_COUNT 10000
+#define FTOA_BENCHMARK_ROUNDS 50
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace ftoa {
+
+static float random(uint32_t& state) {
+  state = state * 1103515245u + 12345u;
+  uint32_t bits = state;
+  state = state * 1103515245u + 12345u;
+  bits = (bits & 0xffff0000u) | (state >> 16);
+  /* The digit loop never ends for subnormals, leave them out */
+  if ((bits & 0x7f800000u) == 0) {
+    bits |= 0x00800000u;
+  }
+  float value;
+  ::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/* Display values, a few integer digits and the fraction */
+static std::vector<float> readings(const size_t& count) {
+  std::vector<float> values(count);
+  uint32_t state = 1;
+  for (size_t i = 0; i < count; i++) {
+    state = state * 1103515245u + 12345u;
+    values[i] = static_cast<float>(state >> 8) / 16384.0F - 512.0F;
+  }
+  return values;
+}
+
+typedef int16_t(*Engine)(float, char*, uint8_t, uint8_t);
+
+static double nanoseconds(
+  Engine engine,
+  const std::vector<float>& values,
+  const uint8_t& prec,
+  uint32_t& checksum) {
+  char buf[9];
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+  for (int r = 0; r < FTOA_BENCHMARK_ROUNDS; r++) {
+    for (size_t i = 0; i < values.size(); i++) {
+      checksum += engine(values[i], buf, 7, prec + 1);
+      checksum += buf[1];
+    }
+  }
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+  return 1.0e9 * elapsed.count() / FTOA_BENCHMARK_ROUNDS / values.size();
+}
+
+}
+}
+}
+}
+
+namespace gatf = ::gos::arduino::testing::ftoa;
+
+TEST(FtoaEngineTest, Exact) {
+  const float values[] = {
+    0.0F, -0.0F, 1.0F, 0.5F, 0.05F, 0.005F, 0.0005F, 9.5F, 9.95F, 9.995F,
+    99.5F, 999.999F, 1234.5678F, -273.15F, 1.0e-38F, 1.0e38F, 3.4e38F };
+  char fast[9], reference[9];
+  for (size_t v = 0; v < sizeof(values) / sizeof(values[0]); v++) {
+    for (uint8_t precision = 0; precision <= 7; precision++) {
+      for (uint8_t maxDecimals = 0; maxDecimals < 10; maxDecimals++) {
+        ::memset(fast, 0, sizeof(fast));
+        ::memset(reference, 0, sizeof(reference));
+        EXPECT_EQ(
+          ftoa_engine_reference(values[v], reference, precision, maxDecimals),
+          ftoa_engine(values[v], fast, precision, maxDecimals))
+          << values[v] << " " << static_cast<int>(precision) << " "
+          << static_cast<int>(maxDecimals);
+        EXPECT_EQ(0, ::memcmp(reference, fast, sizeof(fast)))
+          << values[v] << " " << static_cast<int>(precision) << " "
+          << static_cast<int>(maxDecimals);
+      }
+    }
+  }
+
+  uint32_t state = 1;
+  size_t mismatches = 0;
+  for (int i = 0; i < FTOA_SWEEP_COUNT; i++) {
+    float value = gatf::random(state);
+    /* 8 and 9 are coprime so every pair comes up */
+    uint8_t precision = static_cast<uint8_t>(i % 8);
+    uint8_t maxDecimals = static_cast<uint8_t>(i % 9);
+    ::memset(fast, 0, sizeof(fast));
+    ::memset(reference, 0, sizeof(reference));
+    int16_t fastexp = ftoa_engine(value, fast, precision, maxDecimals);
+    int16_t referenceexp = ftoa_engine_reference(
+      value, reference, precision, maxDecimals);
+    if (fastexp != referenceexp || ::memcmp(reference, fast, sizeof(fast))) {
+      mismatches++;
+    }
+  }
+  EXPECT_EQ(0, mismatches);
+
+  char text[32];
+  dtoa_prf_f(-273.15F, text, 0, 2, 0);
+  EXPECT_STREQ("-273.15", text);
+  dtoa_prf_f(9.995F, text, 8, 1, 0);
+  EXPECT_STREQ("    10.0", text);
+}
+
+TEST(FtoaEngineTest, Benchmark) {
+  std::vector<float> values = gatf::readings(FTOA_BENCHMARK_COUNT);
+  uint32_t fastsum = 0, referencesum = 0;
+  for (uint8_t prec = 0; prec <= 3; prec++) {
+    double reference = gatf::nanoseconds(
+      ftoa_engine_reference, values, prec, referencesum);
+    double fast = gatf::nanoseconds(ftoa_engine, values, prec, fastsum);
+    std::cout << "ftoa_engine precision " << static_cast<int>(prec)
+      << " ns/conversion subtraction " << reference
+      << " division " << fast << std::endl;
+  }
+  EXPECT_EQ(referencesum, fastsum);
+}
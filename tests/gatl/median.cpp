@@ -1,5 +1,7 @@
 #include <vector>
 #include <mutex>
+#include <chrono>
+#include <iostream>
 
 #include <gtest/gtest.h>
 
@@ -8,11 +10,13 @@
 #include <gos/utils/random.h>
 #include <gos/utils/statistics.h>
 #include <gos/utils/expect.h>
+#include <gos/utils/median.h>
 
 #include <gatlmedian.h>
 
 namespace gatl = ::gos::atl;
 namespace gatu = ::gos::arduino::testing::utils;
+namespace gatus = ::gos::arduino::testing::utils::statistics;
 
 typedef std::vector<double> DoubleVector;
 typedef std::vector<uint32_t> DoubleWordVector;
@@ -72,3 +76,47 @@ TEST(GatlMedianTest, RunningMedian) {
 
   mutext.unlock();
 }
+
+TEST(GatlMedianTest, Benchmark) {
+  mutext.lock();
+  const uint16_t sizes[] = { 64, 128, 256 };
+  const size_t count = 4096;
+
+  DoubleVector samples;
+  randomSeed(93);
+  for (size_t i = 0; i < count; i++) {
+    samples.push_back(gatu::random::generate<double>(0, 1024));
+  }
+
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    gatl::statistics::Set<double, uint16_t> set(NAN, sizes[s]);
+    gatl::statistics::Median<double, uint16_t> median(set);
+    gatus::RunningMedian<double, uint16_t> running(sizes[s]);
+
+    double gatlsum = 0.0, runningsum = 0.0;
+    std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+      set.add(samples[i]);
+      gatlsum += median.get();
+    }
+    std::chrono::duration<double> gatltime =
+      std::chrono::steady_clock::now() - start;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; i++) {
+      running.add(samples[i]);
+      runningsum += running.get();
+    }
+    std::chrono::duration<double> runningtime =
+      std::chrono::steady_clock::now() - start;
+    EXPECT_DOUBLE_EQ(gatlsum, runningsum);
+    median.cleanup();
+
+    std::cout << "window " << sizes[s] << " ns/sample gatl Median "
+      << 1.0e9 * gatltime.count() / count
+      << " RunningMedian " << 1.0e9 * runningtime.count() / count
+      << std::endl;
+  }
+
+  mutext.unlock();
+}
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <iostream>
 #include <memory>
 #include <mutex>
 
@@ -17,11 +19,19 @@
 #include <gos/utils/expect.h>
 #include <gos/utils/memory.h>
 #include <gos/utils/binding.h>
+#include <gos/utils/crc.h>
+#include <gos/utils/modbus.h>
+#include <gos/utils/rtu.h>
 
 #define MODBUS_BUFFER_SIZE 64
+#define MODBUS_LOAD_REQUESTS 1000
+#define MODBUS_LOAD_TIMEOUT 1000000
 
 namespace gatum = ::gos::arduino::testing::utils::memory;
 namespace gatub = ::gos::arduino::testing::utils::binding;
+namespace gatuc = ::gos::arduino::testing::utils::crc;
+namespace gatumo = ::gos::arduino::testing::utils::modbus;
+namespace gaturt = ::gos::arduino::testing::utils::rtu;
 
 namespace gatl = ::gos::atl;
 namespace gatlb = ::gos::atl::binding;
@@ -216,6 +226,9 @@ void GatlModbusFixture::crc(
     holder, length);
   EXPECT_EQ(swapedcrc, crcams);
   EXPECT_EQ(swapedcrc, gatlmcrc);
+  EXPECT_EQ(swapedcrc, gatuc::Modbus<>::calculate(buffer, length));
+  EXPECT_EQ(swapedcrc, gatuc::Modbus<gatuc::policy::Slicing>::calculate(
+    buffer, length));
 }
 
 uint16_t GatlModbusFixture::swap(const uint16_t& value) {
@@ -335,6 +348,187 @@ TEST_F(GatlModbusFixture, DISABLED_Loop) {
 #endif
 }
 
+/*
+ * RS-485 line between the load generator and gatlm::loop in virtual
+ * time. Request bytes become available one character time apart and the
+ * response is complete when the expected number of bytes are written.
+ */
+class ModbusLine {
+public:
+  ModbusLine(const MODBUS_TYPE_RATE& rate) :
+    Now(0),
+    Character(gaturt::Timing(rate).Character),
+    start_(0),
+    length_(0),
+    position_(0),
+    written_(0),
+    finished_(0) {
+  }
+
+  void send(const size_t& length) {
+    start_ = Now;
+    length_ = length;
+    position_ = 0;
+    written_ = 0;
+  }
+
+  bool complete() const {
+    if (written_ >= 5 && gatumo::master::exception(Response, written_)) {
+      return true;
+    }
+    return written_ > 0 &&
+      written_ >= gatumo::master::expected(Request, length_);
+  }
+
+  /* Response bytes received and virtual time of the last one */
+  size_t received() const {
+    return written_;
+  }
+  unsigned long latency() const {
+    return finished_ - start_;
+  }
+  unsigned long finished() const {
+    return finished_;
+  }
+
+  int available() const {
+    size_t arrived = static_cast<size_t>((Now - start_) / Character);
+    return static_cast<int>(std::min(arrived, length_) - position_);
+  }
+
+  template<typename B, typename L> size_t read(B* buffer, const L& length) {
+    size_t count = std::min(
+      static_cast<size_t>(length),
+      static_cast<size_t>(available()));
+    ::memcpy(buffer, Request + position_, count);
+    position_ += count;
+    return count;
+  }
+
+  template<typename B, typename L> size_t write(
+    const B* buffer,
+    const L& length) {
+    size_t count = std::min(
+      static_cast<size_t>(length),
+      sizeof(Response) - written_);
+    ::memcpy(Response + written_, buffer, count);
+    written_ += count;
+    finished_ = Now + count * Character;
+    return count;
+  }
+
+  uint8_t Request[GOS_ARDUINO_TESTING_MODBUS_FRAME_SIZE];
+  uint8_t Response[GOS_ARDUINO_TESTING_MODBUS_FRAME_SIZE];
+  unsigned long Now;
+  unsigned long Character;
+
+private:
+  unsigned long start_;
+  size_t length_;
+  size_t position_;
+  size_t written_;
+  unsigned long finished_;
+};
+
+/* Serial and Arduino mock actions forwarding to the line */
+struct LineAvailable {
+  ModbusLine* line;
+  int operator()() const {
+    return line->available();
+  }
+};
+struct LineRead {
+  ModbusLine* line;
+  template<typename B, typename L> size_t operator()(
+    B* buffer,
+    L length) const {
+    return line->read(buffer, length);
+  }
+};
+struct LineWrite {
+  ModbusLine* line;
+  template<typename B, typename L> size_t operator()(
+    const B* buffer,
+    L length) const {
+    return line->write(buffer, length);
+  }
+};
+struct LineMicros {
+  ModbusLine* line;
+  unsigned long operator()() const {
+    return line->Now;
+  }
+};
+
+/*
+ * Load generator harness, run with --gtest_also_run_disabled_tests.
+ * Drives gatlm::loop with a request mix over the serial mock and reports
+ * the latency histogram in virtual microseconds, the throughput and the
+ * exception rate.
+ */
+TEST_F(GatlModbusFixture, DISABLED_Load) {
+  ModbusLine line(Rate);
+  gatumo::Mix mix = { 0x01, 0x0000, 0x0020, 0x0008, 1, 2, 1 };
+  gatumo::Generator generator(mix);
+  gatumo::Load load;
+
+  begin();
+
+#ifdef MODBUS_HANDLER_INTERFACE
+  GatlModbusHandler handler;
+#endif
+
+  LineAvailable availability = { &line };
+  LineRead reader = { &line };
+  LineWrite writer = { &line };
+  LineMicros clock = { &line };
+  EXPECT_CALL(*serial, available())
+    .Times(testing::AnyNumber())
+    .WillRepeatedly(testing::Invoke(availability));
+  EXPECT_CALL(*serial, readBytes(testing::_, testing::_))
+    .Times(testing::AnyNumber())
+    .WillRepeatedly(testing::Invoke(reader));
+  EXPECT_CALL(*serial, write(testing::_, testing::_))
+    .Times(testing::AnyNumber())
+    .WillRepeatedly(testing::Invoke(writer));
+  EXPECT_CALL(*serial, availableForWrite())
+    .Times(testing::AnyNumber())
+    .WillRepeatedly(testing::Return(Time));
+  EXPECT_CALL(*serial, flush()).Times(testing::AnyNumber());
+  EXPECT_CALL(*arduinomock, micros())
+    .Times(testing::AnyNumber())
+    .WillRepeatedly(testing::Invoke(clock));
+  EXPECT_CALL(*arduinomock, digitalWrite(parameter.Control, testing::_))
+    .Times(testing::AnyNumber());
+
+  unsigned long step = line.Character / 4;
+  for (int i = 0; i < MODBUS_LOAD_REQUESTS; i++) {
+    size_t length = generator.next(line.Request);
+    line.send(length);
+    load.request(length);
+    unsigned long deadline = line.Now + MODBUS_LOAD_TIMEOUT;
+    while (!line.complete() && line.Now < deadline) {
+#ifdef MODBUS_HANDLER_INTERFACE
+      gatlm::loop<>(Serial, parameter, handler, variable, request, response);
+#else
+      gatlm::loop<>(Serial, parameter, variable, request, response);
+#endif
+      line.Now += step;
+    }
+    if (line.complete()) {
+      load.response(line.Response, line.received(), line.latency());
+      line.Now = std::max(line.Now, line.finished());
+    } else {
+      load.timeout();
+    }
+  }
+  load.Elapsed = line.Now;
+
+  load.report(std::cout);
+  EXPECT_EQ(MODBUS_LOAD_REQUESTS, load.Requests);
+  EXPECT_EQ(0, load.Invalid);
+}
+
 TEST_F(GatlModbusFixture, ProvideDigitalIndex) {
   MODBUS_TYPE_DEFAULT index;
   MODBUS_TYPE_BIT_INDEX bitindex;
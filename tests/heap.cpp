@@ -0,0 +1,96 @@
+#include <cstdint>
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include <gos/utils/heap.h>
+
+namespace gatu = ::gos::arduino::testing::utils;
+
+TEST(HeapTest, Allocate) {
+  gatu::Heap heap(64);
+  EXPECT_EQ(62, heap.largest());
+
+  char* a = static_cast<char*>(heap.allocate(10));
+  char* b = static_cast<char*>(heap.allocate(10));
+  char* c = static_cast<char*>(heap.allocate(10));
+  ASSERT_NE(nullptr, a);
+  ASSERT_NE(nullptr, b);
+  ASSERT_NE(nullptr, c);
+  EXPECT_TRUE(heap.owns(b));
+  EXPECT_EQ(36, heap.used());
+  EXPECT_EQ(36, heap.peak());
+
+  /* Too large for what is left */
+  EXPECT_EQ(nullptr, heap.allocate(30));
+  EXPECT_EQ(1, heap.Failures);
+
+  /* A hole in the middle is reused for a chunk that fits */
+  heap.release(b);
+  EXPECT_EQ(26, heap.largest());
+  char* d = static_cast<char*>(heap.allocate(8));
+  EXPECT_EQ(b, d);
+
+  /* Releasing the top chunk lowers the break */
+  heap.release(c);
+  heap.release(d);
+  heap.release(a);
+  EXPECT_EQ(0, heap.used());
+  EXPECT_EQ(62, heap.largest());
+  EXPECT_EQ(36, heap.peak());
+  EXPECT_EQ(4, heap.Allocations);
+}
+
+TEST(HeapTest, Reallocate) {
+  gatu::Heap heap(64);
+  char* a = static_cast<char*>(heap.reallocate(nullptr, 4));
+  ::memcpy(a, "abc", 4);
+
+  /* The top chunk grows in place */
+  char* grown = static_cast<char*>(heap.reallocate(a, 20));
+  EXPECT_EQ(a, grown);
+  EXPECT_STREQ("abc", grown);
+
+  /* Blocked by a following chunk it moves and keeps its content */
+  char* b = static_cast<char*>(heap.allocate(4));
+  ASSERT_NE(nullptr, b);
+  char* moved = static_cast<char*>(heap.reallocate(grown, 30));
+  ASSERT_NE(nullptr, moved);
+  EXPECT_NE(grown, moved);
+  EXPECT_STREQ("abc", moved);
+
+  /* No room, the chunk is left alone */
+  EXPECT_EQ(nullptr, heap.reallocate(moved, 60));
+  EXPECT_STREQ("abc", moved);
+
+  /* Shrinking splits the rest off */
+  size_t used = heap.used();
+  EXPECT_EQ(moved, heap.reallocate(moved, 4));
+  EXPECT_EQ(used - 26, heap.used());
+
+  heap.release(moved);
+  heap.release(b);
+  EXPECT_EQ(0, heap.used());
+  EXPECT_EQ(62, heap.largest());
+}
+
+TEST(HeapTest, Limit) {
+  /* Chunk sizes are kept in a 16 bit header as on a device */
+  gatu::Heap heap(1 << 20);
+  EXPECT_EQ(GOS_ARDUINO_TESTING_HEAP_LIMIT, heap.size());
+
+  EXPECT_EQ(nullptr, heap.allocate(70000));
+  EXPECT_EQ(nullptr, heap.allocate(SIZE_MAX));
+  EXPECT_EQ(2, heap.Failures);
+
+  char* a = static_cast<char*>(heap.allocate(heap.largest()));
+  ASSERT_NE(nullptr, a);
+  EXPECT_EQ(GOS_ARDUINO_TESTING_HEAP_LIMIT, heap.used());
+  EXPECT_EQ(nullptr, heap.reallocate(a, 70000));
+  EXPECT_EQ(3, heap.Failures);
+
+  heap.release(a);
+  EXPECT_EQ(0, heap.used());
+  EXPECT_EQ(GOS_ARDUINO_TESTING_HEAP_LIMIT - GOS_ARDUINO_TESTING_HEAP_HEADER,
+    heap.largest());
+}
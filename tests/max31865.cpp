@@ -1,5 +1,3 @@
-#include <mutex>
-
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
@@ -35,8 +33,6 @@ protected:
 
   ArduinoMock* arduinomock;
   SpiMock* spimock;
-
-  std::mutex mutex;
 };
 
 TEST_F(Max31865Test, PwFusionMax31865) {
@@ -148,8 +144,6 @@ TEST_F(Max31865Test, ByteOrder) {
 
 TEST_F(Max31865Test, Behavior) {
 
-  mutex.lock();
-
   const uint8_t pin = 8;
   const uint32_t clock = 16000000 / 64;
 
@@ -199,8 +193,6 @@ TEST_F(Max31865Test, Behavior) {
 
   EXPECT_DOUBLE_EQ(pwfvalue, readvalue);
   EXPECT_DOUBLE_EQ(-188.03125, readvalue);
-
-  mutex.unlock();
 }
 
 TEST_F(Max31865Test, Error) {
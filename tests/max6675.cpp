@@ -43,3 +43,41 @@ TEST(Max6675Test, Max6675) {
   releaseSpiMock();
   releaseArduinoMock();
 }
+
+TEST(Max6675Test, Device) {
+  ArduinoMock* arduinomock = arduinoMockInstance();
+  SpiMock* spimock = spiMockInstance();
+
+  const uint8_t pin = 10;
+  const size_t count = 1024;
+  double value;
+  bool readresult;
+  ::gos::arduino::testing::utils::spi::Max6675 device;
+  spimock->attach(pin, &device);
+  spimock->Capture = false;
+
+  ::gos::Max6675 max6675(pin);
+  EXPECT_CALL(*arduinomock, pinMode(pin, OUTPUT)).
+    Times(testing::Exactly(1));
+  EXPECT_CALL(*arduinomock, digitalWrite(pin, testing::_)).
+    WillRepeatedly(testing::Invoke(spimock, &SpiMock::chipselect));
+  max6675.initialize();
+
+  device.open(true);
+  readresult = max6675.read(value);
+  EXPECT_FALSE(readresult);
+
+  device.open(false);
+  for (size_t i = 0; i < count; i++) {
+    double expected = static_cast<double>(i % 4096) / 4.0;
+    device.temperature(expected);
+    readresult = max6675.read(value);
+    EXPECT_TRUE(readresult);
+    EXPECT_DOUBLE_EQ(expected, value);
+  }
+  EXPECT_EQ(0, spimock->In.bytes());
+  EXPECT_EQ(0, spimock->Underrun);
+
+  releaseSpiMock();
+  releaseArduinoMock();
+}
@@ -0,0 +1,188 @@
+#include <cstring>
+#include <sstream>
+
+#include <gtest/gtest.h>
+
+#include <gos/utils/histogram.h>
+#include <gos/utils/modbus.h>
+
+namespace gatu = ::gos::arduino::testing::utils;
+namespace gatumo = ::gos::arduino::testing::utils::modbus;
+
+TEST(HistogramTest, Record) {
+  gatu::Histogram histogram;
+  EXPECT_EQ(0, histogram.count());
+  EXPECT_EQ(0, histogram.percentile(50.0));
+
+  for (uint64_t i = 1; i <= 1000; i++) {
+    histogram.record(i);
+  }
+  EXPECT_EQ(1000, histogram.count());
+  EXPECT_EQ(1, histogram.minimum());
+  EXPECT_EQ(1000, histogram.maximum());
+  EXPECT_DOUBLE_EQ(500.5, histogram.mean());
+  /* Five significant bits keep the error below 1/16 */
+  EXPECT_NEAR(500, histogram.percentile(50.0), 500 / 16);
+  EXPECT_NEAR(990, histogram.percentile(99.0), 990 / 16);
+  EXPECT_EQ(1000, histogram.percentile(100.0));
+  EXPECT_EQ(1, histogram.percentile(0.0));
+
+  /* Small values are exact */
+  histogram.clear();
+  histogram.record(7, 3);
+  histogram.record(12);
+  EXPECT_EQ(4, histogram.count());
+  EXPECT_EQ(7, histogram.percentile(75.0));
+  EXPECT_EQ(12, histogram.percentile(100.0));
+
+  histogram.clear();
+  histogram.record(0xffffffffffffffffULL);
+  EXPECT_EQ(0xffffffffffffffffULL, histogram.percentile(50.0));
+
+  std::stringstream stream;
+  histogram.report(stream, "us");
+  EXPECT_NE(std::string::npos, stream.str().find("p99"));
+}
+
+TEST(ModbusMasterTest, Frames) {
+  uint8_t frame[GOS_ARDUINO_TESTING_MODBUS_FRAME_SIZE];
+  size_t length;
+
+  length = gatumo::master::read(frame, 0x01, 0x01, 0x000b, 0x0001);
+  ASSERT_EQ(8, length);
+  EXPECT_EQ(0x8c, frame[6]);
+  EXPECT_EQ(0x08, frame[7]);
+  EXPECT_TRUE(gatumo::master::valid(frame, length));
+  EXPECT_EQ(6, gatumo::master::expected(frame, length));
+
+  length = gatumo::master::read(frame, 0x01, 0x03, 0x0000, 0x000a);
+  EXPECT_EQ(25, gatumo::master::expected(frame, length));
+
+  const uint16_t values[] = { 0x000a, 0x0102 };
+  length = gatumo::master::write(frame, 0x11, 0x0001, values, 2);
+  ASSERT_EQ(13, length);
+  EXPECT_EQ(0x10, frame[1]);
+  EXPECT_EQ(0x04, frame[6]);
+  EXPECT_EQ(0x01, frame[9]);
+  EXPECT_EQ(0x02, frame[10]);
+  EXPECT_TRUE(gatumo::master::valid(frame, length));
+  EXPECT_EQ(8, gatumo::master::expected(frame, length));
+
+  frame[8] ^= 0x01;
+  EXPECT_FALSE(gatumo::master::valid(frame, length));
+
+  /* Read exception status, no address or count and a single data byte */
+  const uint8_t status[] = { 0x01, 0x07, 0x41, 0xe2 };
+  EXPECT_TRUE(gatumo::master::valid(status, sizeof(status)));
+  EXPECT_EQ(5, gatumo::master::expected(status, sizeof(status)));
+
+  const uint8_t exception[] = { 0x01, 0x83, 0x02, 0xc0, 0xf1 };
+  EXPECT_TRUE(gatumo::master::valid(exception, sizeof(exception)));
+  EXPECT_TRUE(gatumo::master::exception(exception, sizeof(exception)));
+}
+
+TEST(ModbusMasterTest, Generator) {
+  uint8_t frame[GOS_ARDUINO_TESTING_MODBUS_FRAME_SIZE];
+  gatumo::Mix mix = { 0x01, 0x0010, 0x0020, 0x0008, 1, 2, 1 };
+  gatumo::Generator generator(mix);
+
+  const uint8_t functions[] = { 0x01, 0x03, 0x03, 0x10, 0x01 };
+  const uint16_t addresses[] = { 0x10, 0x18, 0x20, 0x28, 0x10 };
+  for (size_t i = 0; i < sizeof(functions); i++) {
+    size_t length = generator.next(frame);
+    EXPECT_TRUE(gatumo::master::valid(frame, length));
+    EXPECT_EQ(functions[i], frame[1]);
+    EXPECT_EQ(addresses[i], static_cast<uint16_t>(frame[2]) << 8 | frame[3]);
+  }
+}
+
+TEST(ModbusMasterTest, Load) {
+  gatumo::Load load;
+  const uint8_t normal[] = { 0x01, 0x01, 0x01, 0x00, 0x51, 0x88 };
+  const uint8_t exception[] = { 0x01, 0x83, 0x02, 0xc0, 0xf1 };
+  const uint8_t invalid[] = { 0x01, 0x83, 0x02, 0xc0, 0xf2 };
+
+  load.request(8);
+  load.response(normal, sizeof(normal), 1500);
+  load.request(8);
+  load.response(exception, sizeof(exception), 2500);
+  load.request(8);
+  load.response(invalid, sizeof(invalid), 3500);
+  load.request(8);
+  load.timeout();
+  load.Elapsed = 1000000;
+
+  EXPECT_EQ(4, load.Requests);
+  EXPECT_EQ(2, load.Responses);
+  EXPECT_EQ(1, load.Exceptions);
+  EXPECT_EQ(1, load.Invalid);
+  EXPECT_EQ(1, load.Timeouts);
+  EXPECT_EQ(32, load.BytesSent);
+  EXPECT_DOUBLE_EQ(2.0, load.throughput());
+  EXPECT_DOUBLE_EQ(0.5, load.exceptionrate());
+  EXPECT_EQ(2, load.Latency.count());
+}
+
+TEST(ModbusTcpTest, Frames) {
+  uint8_t frame[GOS_ARDUINO_TESTING_MODBUS_FRAME_SIZE];
+  uint8_t adu[GOS_ARDUINO_TESTING_MODBUS_ADU_SIZE];
+  size_t length = gatumo::master::read(frame, 0x01, 0x03, 0x006b, 0x0003);
+
+  size_t adulength = gatumo::tcp::wrap(adu, 0x1234, frame, length);
+  const uint8_t expected[] = {
+    0x12, 0x34, 0x00, 0x00, 0x00, 0x06, 0x01, 0x03, 0x00, 0x6b, 0x00, 0x03 };
+  ASSERT_EQ(sizeof(expected), adulength);
+  EXPECT_EQ(0, ::memcmp(expected, adu, adulength));
+  EXPECT_EQ(0x1234, gatumo::tcp::transaction(adu));
+  EXPECT_EQ(0, gatumo::tcp::expected(adu, 5));
+  EXPECT_EQ(adulength, gatumo::tcp::expected(adu, 6));
+
+  uint8_t back[GOS_ARDUINO_TESTING_MODBUS_FRAME_SIZE];
+  ASSERT_EQ(length, gatumo::tcp::unwrap(back, adu, adulength));
+  EXPECT_EQ(0, ::memcmp(frame, back, length));
+}
+
+TEST(ModbusTcpTest, Session) {
+  gatumo::Mix mix = { 0x01, 0x0000, 0x0010, 0x0001, 0, 1, 0 };
+  gatumo::Generator generator(mix);
+  gatumo::Session session(2);
+  gatumo::Load load;
+  uint8_t first[GOS_ARDUINO_TESTING_MODBUS_ADU_SIZE];
+  uint8_t second[GOS_ARDUINO_TESTING_MODBUS_ADU_SIZE];
+  uint8_t third[GOS_ARDUINO_TESTING_MODBUS_ADU_SIZE];
+
+  EXPECT_LT(0, session.request(first, generator, 100));
+  EXPECT_LT(0, session.request(second, generator, 200));
+  EXPECT_EQ(0, session.request(third, generator, 300));
+  EXPECT_EQ(2, session.outstanding());
+  EXPECT_NE(gatumo::tcp::transaction(first), gatumo::tcp::transaction(second));
+
+  /* Answer out of order, one register of 0x0102 */
+  const uint8_t pdu[] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x05,
+    0x01, 0x03, 0x02, 0x01, 0x02 };
+  uint8_t response[sizeof(pdu)];
+  ::memcpy(response, pdu, sizeof(pdu));
+  ::memcpy(response, second, 2);
+  EXPECT_TRUE(session.response(response, sizeof(response), 1200, load));
+  EXPECT_FALSE(session.response(response, sizeof(response), 1300, load));
+  ::memcpy(response, first, 2);
+
+  /* A foreign protocol or a length field off by one is not a response */
+  response[3] = 0x01;
+  EXPECT_FALSE(session.response(response, sizeof(response), 1400, load));
+  response[3] = 0x00;
+  EXPECT_FALSE(session.response(response, sizeof(response) - 1, 1500, load));
+  response[5] = 0x06;
+  EXPECT_FALSE(session.response(response, sizeof(response), 1600, load));
+  response[5] = 0x05;
+  EXPECT_FALSE(session.response(response, 3, 1700, load));
+  EXPECT_EQ(1, session.outstanding());
+  EXPECT_EQ(4, load.Invalid);
+  EXPECT_TRUE(session.response(response, sizeof(response), 2100, load));
+
+  EXPECT_EQ(0, session.outstanding());
+  EXPECT_EQ(2, load.Responses);
+  EXPECT_EQ(4, load.Invalid);
+  EXPECT_EQ(1000, load.Latency.minimum());
+  EXPECT_EQ(2000, load.Latency.maximum());
+}
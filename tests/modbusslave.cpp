@@ -0,0 +1,556 @@
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <FixedPoints.h>
+#include <FixedPointsCommon.h>
+
+#include <ModbusSlave.h>
+
+#include <gos/utils/crc.h>
+#include <gos/utils/modbus.h>
+#include <gos/utils/rtu.h>
+#include <gos/utils/wordq.h>
+
+#define MODBUS_SLAVE_BENCHMARK_ROUNDS 100000
+#define MODBUS_SLAVE_LOAD_REQUESTS 200
+#define MODBUS_SLAVE_LOAD_TIMEOUT 100000
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace modbusslave {
+
+typedef ::gos::arduino::testing::utils::crc::Modbus<> Crc;
+typedef std::vector<uint8_t> Frame;
+
+static Frame seal(Frame frame) {
+  uint16_t crc = Crc::calculate(frame.data(), frame.size());
+  frame.push_back(static_cast<uint8_t>(crc & 0xff));
+  frame.push_back(static_cast<uint8_t>(crc >> 8));
+  return frame;
+}
+
+static void push(utils::WordQueue& queue, const Frame& frame) {
+  queue.pushbytes(frame.data(), frame.size());
+}
+
+/* The reply at the front of the queue, empty when its CRC is wrong */
+static Frame reply(utils::WordQueue& queue, const size_t& length) {
+  Frame frame(length);
+  queue.popbytes(frame.data(), length);
+  if (length < 4 || Crc::calculate(frame.data(), length - 2) !=
+    (frame[length - 2] | static_cast<uint16_t>(frame[length - 1]) << 8)) {
+    return Frame();
+  }
+  frame.resize(length - 2);
+  return frame;
+}
+
+/* Requests seen by the callbacks, a read of address 9 fails */
+static std::vector<uint16_t> addresses;
+
+static uint8_t record(uint8_t function, uint16_t address, uint16_t length) {
+  addresses.push_back(address);
+  return address == 9 ? ::gos::arduino::mock::STATUS_SLAVE_DEVICE_FAILURE :
+    ::gos::arduino::mock::STATUS_OK;
+}
+
+}
+}
+}
+}
+
+namespace gam = ::gos::arduino::mock;
+namespace gatm = ::gos::arduino::testing::modbusslave;
+namespace gatu = ::gos::arduino::testing::utils;
+namespace gatumo = ::gos::arduino::testing::utils::modbus;
+namespace gaturt = ::gos::arduino::testing::utils::rtu;
+
+class ModbusSlaveTest : public ::testing::Test {
+protected:
+  ModbusSlaveTest() : slave(16, 16, gam::Modbus::Pattern::Increase) {
+  }
+
+  void SetUp() override {
+    gatm::addresses.clear();
+    slave.creatediscretes(16);
+    slave.cbVector[gam::CB_READ_HOLDING_REGISTERS] = gatm::record;
+    slave.cbVector[gam::CB_WRITE_HOLDING_REGISTERS] = gatm::record;
+  }
+
+  gam::Modbus slave;
+  gatu::WordQueue receive;
+  gatu::WordQueue transmit;
+};
+
+TEST_F(ModbusSlaveTest, Assembly) {
+  gatm::Frame read = gatm::seal({ 1, 3, 0, 2, 0, 3 });
+
+  /* A frame arriving in pieces is answered once it is complete */
+  receive.pushbytes(read.data(), 3);
+  EXPECT_EQ(0, slave.poll(receive, transmit));
+  receive.pushbytes(read.data() + 3, read.size() - 3);
+  ASSERT_EQ(11, slave.poll(receive, transmit));
+  EXPECT_EQ(gatm::Frame({ 1, 3, 6, 0, 2, 0, 3, 0, 4 }),
+    gatm::reply(transmit, 11));
+
+  /* The byte count decides the length of a write multiple */
+  gatm::Frame write = gatm::seal(
+    { 1, 16, 0, 4, 0, 2, 4, 0x12, 0x34, 0x56, 0x78 });
+  receive.pushbytes(write.data(), 6);
+  EXPECT_EQ(0, slave.poll(receive, transmit));
+  receive.pushbytes(write.data() + 6, write.size() - 6);
+
+  /* Back to back requests are split and answered one per poll */
+  gatm::push(receive, read);
+  ASSERT_EQ(8, slave.poll(receive, transmit));
+  EXPECT_EQ(gatm::Frame({ 1, 16, 0, 4, 0, 2 }), gatm::reply(transmit, 8));
+  EXPECT_EQ(0x1234, slave.Registers[4]);
+  EXPECT_EQ(0x5678, slave.Registers[5]);
+  ASSERT_EQ(11, slave.poll(receive, transmit));
+  EXPECT_EQ(0, receive.bytes());
+  EXPECT_EQ(0, slave.poll(receive, transmit));
+
+  EXPECT_EQ(3, slave.Requests);
+  EXPECT_EQ(read.size() * 2 + write.size(), slave.getTotalBytesReceived());
+  EXPECT_EQ(30, slave.getTotalBytesSent());
+}
+
+TEST_F(ModbusSlaveTest, Crc) {
+  gatm::Frame write = gatm::seal({ 1, 6, 0, 1, 0, 7 });
+  write[3] ^= 0x01;
+  gatm::push(receive, write);
+  EXPECT_EQ(0, slave.poll(receive, transmit));
+  EXPECT_EQ(1, slave.Discarded);
+  EXPECT_EQ(0, slave.Requests);
+  EXPECT_EQ(1, slave.Registers[1]);
+  EXPECT_TRUE(gatm::addresses.empty());
+
+  /* The next frame is read from where the bad one ended */
+  gatm::push(receive, gatm::seal({ 1, 6, 0, 1, 0, 7 }));
+  EXPECT_EQ(8, slave.poll(receive, transmit));
+  EXPECT_EQ(7, slave.Registers[1]);
+}
+
+TEST_F(ModbusSlaveTest, Unit) {
+  gatm::push(receive, gatm::seal({ 2, 6, 0, 1, 0, 7 }));
+  EXPECT_EQ(0, slave.poll(receive, transmit));
+  EXPECT_EQ(0, receive.bytes());
+  EXPECT_EQ(0, slave.Requests);
+  EXPECT_EQ(1, slave.Registers[1]);
+
+  slave.setUnitAddress(2);
+  gatm::push(receive, gatm::seal({ 2, 6, 0, 1, 0, 7 }));
+  EXPECT_EQ(8, slave.poll(receive, transmit));
+  EXPECT_EQ(gatm::Frame({ 2, 6, 0, 1, 0, 7 }), gatm::reply(transmit, 8));
+}
+
+TEST_F(ModbusSlaveTest, Exceptions) {
+  const struct {
+    gatm::Frame request;
+    uint8_t status;
+  } cases[] = {
+    { { 1, 3, 0, 15, 0, 2 }, gam::STATUS_ILLEGAL_DATA_ADDRESS },
+    { { 1, 3, 0, 0, 0, 0 }, gam::STATUS_ILLEGAL_DATA_VALUE },
+    { { 1, 3, 0, 0, 0, 126 }, gam::STATUS_ILLEGAL_DATA_VALUE },
+    { { 1, 5, 0, 0, 0x12, 0x34 }, gam::STATUS_ILLEGAL_DATA_VALUE },
+    { { 1, 6, 0, 16, 0, 1 }, gam::STATUS_ILLEGAL_DATA_ADDRESS },
+    { { 1, 3, 0, 9, 0, 1 }, gam::STATUS_SLAVE_DEVICE_FAILURE },
+    { { 1, 0x2b, 0x0e, 1, 0 }, gam::STATUS_ILLEGAL_FUNCTION } };
+
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    gatm::push(receive, gatm::seal(cases[i].request));
+    ASSERT_EQ(5, slave.poll(receive, transmit)) << i;
+    uint8_t function = static_cast<uint8_t>(cases[i].request[1] | 0x80);
+    EXPECT_EQ(gatm::Frame({ 1, function, cases[i].status }),
+      gatm::reply(transmit, 5)) << i;
+  }
+  EXPECT_EQ(7, slave.Requests);
+  EXPECT_EQ(7, slave.Exceptions);
+  EXPECT_EQ(0, slave.Discarded);
+}
+
+TEST_F(ModbusSlaveTest, Broadcast) {
+  /* A broadcast read is neither executed nor answered */
+  gatm::push(receive, gatm::seal({ 0, 3, 0, 2, 0, 1 }));
+  EXPECT_EQ(0, slave.poll(receive, transmit));
+  EXPECT_EQ(0, receive.bytes());
+  EXPECT_TRUE(gatm::addresses.empty());
+  EXPECT_EQ(0, slave.Requests);
+  EXPECT_EQ(1, slave.Discarded);
+
+  /* A broadcast write is stored without a reply */
+  gatm::push(receive, gatm::seal({ 0, 6, 0, 3, 0x12, 0x34 }));
+  EXPECT_EQ(0, slave.poll(receive, transmit));
+  EXPECT_EQ(0x1234, slave.Registers[3]);
+  EXPECT_EQ(std::vector<uint16_t>({ 3 }), gatm::addresses);
+  EXPECT_EQ(1, slave.Requests);
+  EXPECT_EQ(0, transmit.bytes());
+}
+
+TEST_F(ModbusSlaveTest, Oversize) {
+  /* A byte count of 250 makes a 259 byte frame, beyond the RTU limit */
+  gatm::Frame large = { 1, 16, 0, 0, 0, 125, 250 };
+  large.resize(7 + 250, 0xaa);
+  large = gatm::seal(large);
+  gatm::Frame read = gatm::seal({ 1, 3, 0, 2, 0, 1 });
+
+  gatm::push(receive, large);
+  gatm::push(receive, read);
+  EXPECT_EQ(0, slave.poll(receive, transmit));
+  EXPECT_EQ(1, slave.Discarded);
+  ASSERT_EQ(7, slave.poll(receive, transmit));
+  EXPECT_EQ(gatm::Frame({ 1, 3, 2, 0, 2 }), gatm::reply(transmit, 7));
+
+  /* Also when the rest of the frame is still on its way */
+  receive.pushbytes(large.data(), 40);
+  EXPECT_EQ(0, slave.poll(receive, transmit));
+  EXPECT_EQ(2, slave.Discarded);
+  receive.pushbytes(large.data() + 40, 100);
+  EXPECT_EQ(0, slave.poll(receive, transmit));
+  receive.pushbytes(large.data() + 140, large.size() - 140);
+  gatm::push(receive, read);
+  ASSERT_EQ(7, slave.poll(receive, transmit));
+  EXPECT_EQ(gatm::Frame({ 1, 3, 2, 0, 2 }), gatm::reply(transmit, 7));
+  EXPECT_EQ(0, receive.bytes());
+  EXPECT_EQ(2, slave.Discarded);
+  EXPECT_EQ(2, slave.Requests);
+}
+
+TEST_F(ModbusSlaveTest, Unknown) {
+  /* An unknown function ends where its CRC checks, the next one stays */
+  gatm::Frame unknown = gatm::seal({ 1, 0x2b, 0x0e, 1, 0 });
+  gatm::Frame read = gatm::seal({ 1, 3, 0, 2, 0, 1 });
+  gatm::push(receive, unknown);
+  gatm::push(receive, read);
+  ASSERT_EQ(5, slave.poll(receive, transmit));
+  EXPECT_EQ(gatm::Frame({ 1, 0xab, gam::STATUS_ILLEGAL_FUNCTION }),
+    gatm::reply(transmit, 5));
+  ASSERT_EQ(7, slave.poll(receive, transmit));
+  EXPECT_EQ(gatm::Frame({ 1, 3, 2, 0, 2 }), gatm::reply(transmit, 7));
+
+  /* Nothing is answered before the CRC is in */
+  receive.pushbytes(unknown.data(), 5);
+  EXPECT_EQ(0, slave.poll(receive, transmit));
+  EXPECT_EQ(5, receive.bytes());
+  receive.pushbytes(unknown.data() + 5, unknown.size() - 5);
+  ASSERT_EQ(5, slave.poll(receive, transmit));
+  EXPECT_EQ(gatm::Frame({ 1, 0xab, gam::STATUS_ILLEGAL_FUNCTION }),
+    gatm::reply(transmit, 5));
+
+  /* Without a CRC that checks within the buffer all of it is dropped */
+  gatm::Frame noise(MODBUS_MAX_BUFFER + 4, 0xaa);
+  noise[0] = 1;
+  noise[1] = 0x41;
+  gatm::push(receive, noise);
+  EXPECT_EQ(0, slave.poll(receive, transmit));
+  EXPECT_EQ(0, receive.bytes());
+  EXPECT_EQ(1, slave.Discarded);
+  EXPECT_EQ(3, slave.Requests);
+}
+
+TEST_F(ModbusSlaveTest, Wrapped) {
+  gatu::WordQueue ring(gatu::byte::Order::BigEndian, 32);
+  gatm::Frame write = gatm::seal(
+    { 1, 16, 0, 6, 0, 3, 6, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 });
+  gatm::Frame read = gatm::seal({ 1, 3, 0, 6, 0, 3 });
+
+  /* Put the head so the ring wraps inside the second register */
+  uint8_t filler[32] = { 0 };
+  ring.pushbytes(filler, 22);
+  ring.drop(22);
+  gatm::push(ring, write);
+  gatm::push(ring, read);
+  gatu::Span first, second;
+  ring.peek(first, second);
+  ASSERT_EQ(10, first.size);
+
+  ASSERT_EQ(8, slave.poll(ring, transmit));
+  EXPECT_EQ(gatm::Frame({ 1, 16, 0, 6, 0, 3 }), gatm::reply(transmit, 8));
+  EXPECT_EQ(0x1122, slave.Registers[6]);
+  EXPECT_EQ(0x3344, slave.Registers[7]);
+  EXPECT_EQ(0x5566, slave.Registers[8]);
+
+  /* The frame was read in place, nothing was moved */
+  gatu::Span after, rest;
+  ring.peek(after, rest);
+  EXPECT_EQ(second.data + write.size() - first.size, after.data);
+  EXPECT_EQ(read.size(), after.size);
+
+  ASSERT_EQ(11, slave.poll(ring, transmit));
+  EXPECT_EQ(gatm::Frame({ 1, 3, 6, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66 }),
+    gatm::reply(transmit, 11));
+  EXPECT_EQ(0, slave.Discarded);
+}
+
+TEST_F(ModbusSlaveTest, Line) {
+  gaturt::Clock clock;
+  gaturt::Line request(clock, 9600), response(clock, 9600);
+  const gaturt::Timing& timing = request.timing();
+  gatm::Frame read = gatm::seal({ 1, 3, 0, 2, 0, 1 });
+  uint8_t received[MODBUS_MAX_BUFFER];
+
+  /* The frame is complete only after t3.5 of silence */
+  request.send(read.data(), read.size());
+  clock.until(request.idle());
+  EXPECT_EQ(0, slave.poll(request, response));
+  clock.until(request.idle() + timing.Interframe - 1);
+  EXPECT_EQ(0, slave.poll(request, response));
+  clock.advance(1);
+  ASSERT_EQ(7, slave.poll(request, response));
+  clock.until(response.idle());
+  ASSERT_EQ(7, response.read(received, sizeof(received)));
+  EXPECT_EQ(0x00, received[3]);
+  EXPECT_EQ(0x02, received[4]);
+
+  /* A gap longer than t1.5 inside the frame breaks it */
+  request.send(read.data(), 3);
+  clock.until(request.idle() + timing.Interchar + 1);
+  request.send(read.data() + 3, read.size() - 3);
+  clock.until(request.idle() + timing.Interframe);
+  EXPECT_EQ(0, slave.poll(request, response));
+  EXPECT_EQ(1, slave.Discarded);
+  EXPECT_EQ(1, slave.Requests);
+
+  /* Up to t1.5 the characters still belong to the same frame */
+  request.send(read.data(), 3);
+  clock.until(request.idle() + timing.Interchar);
+  request.send(read.data() + 3, read.size() - 3);
+  clock.until(request.idle() + timing.Interframe);
+  EXPECT_EQ(7, slave.poll(request, response));
+
+  /* A t3.5 gap splits what is waiting into two frames */
+  request.send(read.data(), 3);
+  clock.until(request.idle() + timing.Interframe);
+  request.send(read.data(), read.size());
+  clock.until(request.idle() + timing.Interframe);
+  EXPECT_EQ(0, slave.poll(request, response));
+  EXPECT_EQ(2, slave.Discarded);
+  EXPECT_EQ(7, slave.poll(request, response));
+  EXPECT_EQ(3, slave.Requests);
+  EXPECT_EQ(0, request.available());
+}
+
+TEST_F(ModbusSlaveTest, Bits) {
+  slave.createcoils(20);
+  slave.createpattern(gam::Modbus::Pattern::TrueFalse);
+  slave.Discretes.set(3, true);
+  slave.Discretes.set(12, true);
+
+  /* Coils go out least significant bit first from the start address */
+  gatm::push(receive, gatm::seal({ 1, 1, 0, 1, 0, 10 }));
+  ASSERT_EQ(7, slave.poll(receive, transmit));
+  EXPECT_EQ(gatm::Frame({ 1, 1, 2, 0xaa, 0x02 }), gatm::reply(transmit, 7));
+  gatm::push(receive, gatm::seal({ 1, 2, 0, 0, 0, 16 }));
+  ASSERT_EQ(7, slave.poll(receive, transmit));
+  EXPECT_EQ(gatm::Frame({ 1, 2, 2, 0x08, 0x10 }), gatm::reply(transmit, 7));
+
+  gatm::push(receive, gatm::seal({ 1, 5, 0, 1, 0xff, 0 }));
+  ASSERT_EQ(8, slave.poll(receive, transmit));
+  EXPECT_EQ(gatm::Frame({ 1, 5, 0, 1, 0xff, 0 }), gatm::reply(transmit, 8));
+  EXPECT_TRUE(slave.Coils.get(1));
+  gatm::push(receive, gatm::seal({ 1, 5, 0, 0, 0, 0 }));
+  ASSERT_EQ(8, slave.poll(receive, transmit));
+  gatm::reply(transmit, 8);
+  EXPECT_FALSE(slave.Coils.get(0));
+
+  /* Ten coils from 3 unpacked from 0x01cd and read back the same */
+  gatm::push(receive, gatm::seal({ 1, 15, 0, 3, 0, 10, 2, 0xcd, 0x01 }));
+  ASSERT_EQ(8, slave.poll(receive, transmit));
+  EXPECT_EQ(gatm::Frame({ 1, 15, 0, 3, 0, 10 }), gatm::reply(transmit, 8));
+  const bool written[] = {
+    true, false, true, true, false, false, true, true, true, false };
+  for (size_t i = 0; i < sizeof(written); i++) {
+    EXPECT_EQ(written[i], slave.Coils.get(3 + i)) << i;
+  }
+  EXPECT_TRUE(slave.Coils.get(2));
+  EXPECT_FALSE(slave.Coils.get(13));
+  gatm::push(receive, gatm::seal({ 1, 1, 0, 3, 0, 10 }));
+  ASSERT_EQ(7, slave.poll(receive, transmit));
+  EXPECT_EQ(gatm::Frame({ 1, 1, 2, 0xcd, 0x01 }), gatm::reply(transmit, 7));
+
+  /* The byte count has to match the coil count */
+  gatm::push(receive, gatm::seal({ 1, 15, 0, 3, 0, 10, 1, 0xcd }));
+  ASSERT_EQ(5, slave.poll(receive, transmit));
+  EXPECT_EQ(gatm::Frame({ 1, 0x8f, gam::STATUS_ILLEGAL_DATA_VALUE }),
+    gatm::reply(transmit, 5));
+  gatm::push(receive, gatm::seal({ 1, 1, 0, 15, 0, 6 }));
+  ASSERT_EQ(5, slave.poll(receive, transmit));
+  EXPECT_EQ(gatm::Frame({ 1, 0x81, gam::STATUS_ILLEGAL_DATA_ADDRESS }),
+    gatm::reply(transmit, 5));
+  EXPECT_TRUE(slave.Coils.get(3));
+}
+
+TEST_F(ModbusSlaveTest, Registers) {
+  const float floats[] = { 1.5F, -0.25F };
+  const int32_t integers[] = { 0x12345678, -2 };
+  const ::FixedPoints::SQ15x16 fixed(-2.75);
+  /* The values high word first as they go out on the wire */
+  const uint16_t words[] = {
+    0x3fc0, 0x0000, 0xbe80, 0x0000,
+    0x1234, 0x5678, 0xffff, 0xfffe,
+    0xfffd, 0x4000 };
+  const gam::WordOrder orders[] = {
+    gam::WordOrder::LowFirst, gam::WordOrder::HighFirst };
+
+  for (size_t o = 0; o < sizeof(orders) / sizeof(orders[0]); o++) {
+    gam::WordOrder order = orders[o];
+    slave.createpattern(gam::Modbus::Pattern::Increase);
+    EXPECT_EQ(gam::STATUS_OK, slave.setregisters(3, floats, 2, order));
+    EXPECT_EQ(gam::STATUS_OK, slave.setregisters(7, integers, 2, order));
+    EXPECT_EQ(gam::STATUS_OK, slave.setregisters(11, fixed, order));
+    EXPECT_EQ(gam::STATUS_ILLEGAL_DATA_ADDRESS,
+      slave.setregisters(15, fixed, order));
+
+    gatm::push(receive, gatm::seal({ 1, 3, 0, 2, 0, 12 }));
+    ASSERT_EQ(29, slave.poll(receive, transmit));
+    gatm::Frame expected = { 1, 3, 24, 0, 2 };
+    for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); i++) {
+      /* Low first swaps the two words of each value */
+      uint16_t word = order == gam::WordOrder::HighFirst ?
+        words[i] : words[i ^ 1];
+      expected.push_back(static_cast<uint8_t>(word >> 8));
+      expected.push_back(static_cast<uint8_t>(word & 0xff));
+    }
+    expected.push_back(0);
+    expected.push_back(13);
+    EXPECT_EQ(expected, gatm::reply(transmit, 29)) << o;
+
+    float floatresults[2];
+    int32_t integerresults[2];
+    ::FixedPoints::SQ15x16 fixedresult;
+    EXPECT_EQ(gam::STATUS_OK, slave.getregisters(3, floatresults, 2, order));
+    EXPECT_EQ(gam::STATUS_OK,
+      slave.getregisters(7, integerresults, 2, order));
+    EXPECT_EQ(gam::STATUS_OK, slave.getregisters(11, &fixedresult, 1, order));
+    EXPECT_FLOAT_EQ(floats[1], floatresults[1]);
+    EXPECT_EQ(integers[0], integerresults[0]);
+    EXPECT_EQ(fixed.getInternal(), fixedresult.getInternal());
+  }
+}
+
+TEST_F(ModbusSlaveTest, Serve) {
+  uint8_t frame[GOS_ARDUINO_TESTING_MODBUS_FRAME_SIZE];
+  uint8_t adu[GOS_ARDUINO_TESTING_MODBUS_ADU_SIZE];
+  uint8_t reply[GOS_ARDUINO_TESTING_MODBUS_ADU_SIZE];
+  const uint16_t values[] = { 0xbeef, 0xcafe };
+
+  /* Three pipelined requests, the last addressed to the TCP unit 255 */
+  size_t length = gatumo::master::read(frame, 1, 3, 2, 2);
+  gatm::push(receive, gatm::Frame(adu, adu +
+    gatumo::tcp::wrap(adu, 0x0101, frame, length)));
+  length = gatumo::master::write(frame, 1, 10, values, 2);
+  gatm::push(receive, gatm::Frame(adu, adu +
+    gatumo::tcp::wrap(adu, 0x0102, frame, length)));
+  length = gatumo::master::read(frame, 255, 3, 10, 2);
+  size_t last = gatumo::tcp::wrap(adu, 0x0103, frame, length);
+
+  /* The last one arrives in two parts */
+  receive.pushbytes(adu, 4);
+  EXPECT_EQ(2, slave.serve(receive, transmit));
+  EXPECT_EQ(4, receive.bytes());
+  receive.pushbytes(adu + 4, 5);
+  EXPECT_EQ(0, slave.serve(receive, transmit));
+  receive.pushbytes(adu + 9, last - 9);
+  EXPECT_EQ(1, slave.serve(receive, transmit));
+  EXPECT_EQ(0, receive.bytes());
+
+  const gatm::Frame expected[] = {
+    { 0x01, 0x01, 0, 0, 0, 7, 1, 3, 4, 0, 2, 0, 3 },
+    { 0x01, 0x02, 0, 0, 0, 6, 1, 16, 0, 10, 0, 2 },
+    { 0x01, 0x03, 0, 0, 0, 7, 255, 3, 4, 0xbe, 0xef, 0xca, 0xfe } };
+  for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+    length = gatumo::tcp::expected(transmit.peek().data, transmit.bytes());
+    ASSERT_EQ(expected[i].size(), length) << i;
+    transmit.popbytes(reply, length);
+    EXPECT_EQ(expected[i], gatm::Frame(reply, reply + length)) << i;
+  }
+
+  /* A protocol other than Modbus is dropped and the next ADU is served */
+  length = gatumo::master::read(frame, 1, 3, 2, 1);
+  last = gatumo::tcp::wrap(adu, 0x0104, frame, length);
+  adu[3] = 0x01;
+  receive.pushbytes(adu, last);
+  adu[3] = 0x00;
+  receive.pushbytes(adu, last);
+  EXPECT_EQ(1, slave.serve(receive, transmit));
+  EXPECT_EQ(1, slave.Discarded);
+  EXPECT_EQ(11, transmit.bytes());
+  EXPECT_EQ(4, slave.Requests);
+}
+
+TEST_F(ModbusSlaveTest, Benchmark) {
+  /* The largest read, 125 registers, from request to sealed reply */
+  slave.createregisters(125);
+  slave.createpattern(gam::Modbus::Pattern::Increase);
+  slave.cbVector[gam::CB_READ_HOLDING_REGISTERS] = nullptr;
+  gatm::Frame read = gatm::seal({ 1, 3, 0, 0, 0, 125 });
+  uint8_t reply[MODBUS_MAX_BUFFER];
+
+  size_t replied = 0;
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+  for (int r = 0; r < MODBUS_SLAVE_BENCHMARK_ROUNDS; r++) {
+    gatm::push(receive, read);
+    replied += slave.poll(receive, transmit);
+    transmit.popbytes(reply, sizeof(reply));
+  }
+  std::chrono::duration<double> elapsed =
+    std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(255u * MODBUS_SLAVE_BENCHMARK_ROUNDS, replied);
+  EXPECT_EQ(0x7c, reply[252]);
+
+  std::cout << "125 register read ns/request "
+    << 1.0e9 * elapsed.count() / MODBUS_SLAVE_BENCHMARK_ROUNDS << std::endl;
+}
+
+/* A short load run end to end, the generator against the slave in time */
+TEST_F(ModbusSlaveTest, Load) {
+  slave.createcoils(32);
+  slave.createregisters(32);
+  gaturt::Clock clock;
+  gaturt::Line request(clock, 115200), response(clock, 115200);
+  const gaturt::Timing& timing = request.timing();
+  gatumo::Mix mix = { 0x01, 0x0000, 0x0020, 0x0008, 1, 2, 1 };
+  gatumo::Generator generator(mix);
+  gatumo::Load load;
+  uint8_t frame[GOS_ARDUINO_TESTING_MODBUS_FRAME_SIZE];
+  uint8_t reply[GOS_ARDUINO_TESTING_MODBUS_FRAME_SIZE];
+
+  for (int i = 0; i < MODBUS_SLAVE_LOAD_REQUESTS; i++) {
+    size_t length = generator.next(frame);
+    size_t expected = gatumo::master::expected(frame, length);
+    uint64_t start = clock.Now;
+    request.send(frame, length);
+    load.request(length);
+    size_t received = 0;
+    while (received < expected &&
+      clock.Now < start + MODBUS_SLAVE_LOAD_TIMEOUT) {
+      clock.advance(timing.Character / 4);
+      slave.poll(request, response);
+      received += response.read(reply + received, sizeof(reply) - received);
+    }
+    if (received < expected) {
+      load.timeout();
+    } else {
+      load.response(reply, received, response.last() - start);
+    }
+  }
+  load.Elapsed = clock.Now;
+
+  EXPECT_EQ(MODBUS_SLAVE_LOAD_REQUESTS, load.Requests);
+  EXPECT_EQ(MODBUS_SLAVE_LOAD_REQUESTS, load.Responses);
+  EXPECT_EQ(0, load.Invalid);
+  EXPECT_EQ(0, load.Exceptions);
+  EXPECT_EQ(0, load.Timeouts);
+  EXPECT_EQ(MODBUS_SLAVE_LOAD_REQUESTS, load.Latency.count());
+  /* Request, t3.5 and reply on the wire are the least a request takes */
+  EXPECT_LE(8u * timing.Character + timing.Interframe + 6u * timing.Character,
+    load.Latency.minimum());
+  EXPECT_GT(load.throughput(), 0.0);
+  EXPECT_EQ(MODBUS_SLAVE_LOAD_REQUESTS, slave.Requests);
+  load.report(std::cout);
+}
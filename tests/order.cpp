@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gos/utils/order.h>
+
+#define BYTE_ORDER_BENCHMARK_COUNT 125
+#define BYTE_ORDER_BENCHMARK_ROUNDS 100000
+
+namespace gatub = ::gos::arduino::testing::utils::byte;
+
+TEST(ByteOrderTest, Block) {
+  /* 125 registers, the largest read, plus an odd tail for the lanes */
+  const size_t count = 125;
+  std::vector<uint16_t> words(count), back(count);
+  std::vector<uint8_t> bytes(2 * count), expected(2 * count);
+  for (size_t i = 0; i < count; i++) {
+    words[i] = static_cast<uint16_t>(0x0101 * i + 0x1234);
+    expected[2 * i] = gatub::fyrstbyte(words[i]);
+    expected[2 * i + 1] = gatub::secondbyte(words[i]);
+  }
+
+  gatub::store(bytes.data(), words.data(), count);
+  EXPECT_EQ(expected, bytes);
+  gatub::load(back.data(), bytes.data(), count);
+  EXPECT_EQ(words, back);
+
+  gatub::store(bytes.data(), words.data(), count, gatub::Order::LittleEndian);
+  EXPECT_EQ(gatub::fyrstbyte(words[3], gatub::Order::LittleEndian), bytes[6]);
+  gatub::load(back.data(), bytes.data(), count, gatub::Order::LittleEndian);
+  EXPECT_EQ(words, back);
+
+  /* Every length up to two lanes, so each tail size is covered */
+  for (size_t length = 0; length <= 8; length++) {
+    std::fill(bytes.begin(), bytes.end(), 0);
+    gatub::store(bytes.data(), words.data(), length);
+    EXPECT_TRUE(std::equal(
+      expected.begin(), expected.begin() + 2 * length, bytes.begin()));
+    EXPECT_EQ(0, bytes[2 * length]) << length;
+  }
+}
+
+TEST(ByteOrderTest, Benchmark) {
+  const size_t count = BYTE_ORDER_BENCHMARK_COUNT;
+  std::vector<uint16_t> words(count);
+  std::vector<uint8_t> bytes(2 * count), expected(2 * count);
+  for (size_t i = 0; i < count; i++) {
+    words[i] = static_cast<uint16_t>(0x0101 * i + 0x1234);
+    expected[2 * i] = gatub::fyrstbyte(words[i]);
+    expected[2 * i + 1] = gatub::secondbyte(words[i]);
+  }
+
+  std::chrono::steady_clock::time_point start =
+    std::chrono::steady_clock::now();
+  for (int r = 0; r < BYTE_ORDER_BENCHMARK_ROUNDS; r++) {
+    for (size_t i = 0; i < count; i++) {
+      bytes[2 * i] = gatub::fyrstbyte(words[i]);
+      bytes[2 * i + 1] = gatub::secondbyte(words[i]);
+    }
+  }
+  std::chrono::duration<double> perword =
+    std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(expected, bytes);
+
+  start = std::chrono::steady_clock::now();
+  for (int r = 0; r < BYTE_ORDER_BENCHMARK_ROUNDS; r++) {
+    gatub::store(bytes.data(), words.data(), count);
+  }
+  std::chrono::duration<double> block =
+    std::chrono::steady_clock::now() - start;
+  EXPECT_EQ(expected, bytes);
+
+  std::cout << count << " registers ns word by word "
+    << 1.0e9 * perword.count() / BYTE_ORDER_BENCHMARK_ROUNDS
+    << " block " << 1.0e9 * block.count() / BYTE_ORDER_BENCHMARK_ROUNDS
+    << std::endl;
+}
@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <FixedPoints.h>
+#include <FixedPointsCommon.h>
+
+#include <gos/utils/registers.h>
+
+namespace gatu = ::gos::arduino::testing::utils;
+namespace gatur = ::gos::arduino::testing::utils::registers;
+
+typedef gatu::word::Order WordOrder;
+
+TEST(RegistersTest, Width) {
+  static_assert(gatur::Width<uint16_t>::value == 1, "uint16_t");
+  static_assert(gatur::Width<float>::value == 2, "float");
+  static_assert(gatur::Width<int32_t>::value == 2, "int32_t");
+  static_assert(gatur::Width<::FixedPoints::SQ15x16>::value == 2, "SQ15x16");
+  static_assert(gatur::Width<double>::value == 4, "double");
+}
+
+TEST(RegistersTest, Order) {
+  uint16_t registers[4];
+  int32_t value = 0x12345678, result;
+
+  gatur::put(registers, &value, 1, WordOrder::LowFirst);
+  EXPECT_EQ(0x5678, registers[0]);
+  EXPECT_EQ(0x1234, registers[1]);
+  gatur::get(&result, registers, 1, WordOrder::LowFirst);
+  EXPECT_EQ(value, result);
+
+  gatur::put(registers, &value, 1, WordOrder::HighFirst);
+  EXPECT_EQ(0x1234, registers[0]);
+  EXPECT_EQ(0x5678, registers[1]);
+  gatur::get(&result, registers, 1, WordOrder::HighFirst);
+  EXPECT_EQ(value, result);
+
+  uint64_t wide = 0x0001000200030004ULL, wideresult;
+  gatur::put(registers, &wide, 1, WordOrder::HighFirst);
+  EXPECT_EQ(0x0001, registers[0]);
+  EXPECT_EQ(0x0002, registers[1]);
+  EXPECT_EQ(0x0003, registers[2]);
+  EXPECT_EQ(0x0004, registers[3]);
+  gatur::get(&wideresult, registers, 1, WordOrder::HighFirst);
+  EXPECT_EQ(wide, wideresult);
+}
+
+TEST(RegistersTest, Snapshot) {
+  const size_t count = 1000;
+  std::vector<float> values(count), results(count);
+  std::vector<uint16_t> registers(2 * count);
+  for (size_t i = 0; i < count; i++) {
+    values[i] = 0.01F + static_cast<float>(i) * 1.1F;
+  }
+
+  gatur::put(registers.data(), values.data(), count, WordOrder::LowFirst);
+  gatur::get(results.data(), registers.data(), count, WordOrder::LowFirst);
+  EXPECT_EQ(values, results);
+
+  gatur::put(registers.data(), values.data(), count, WordOrder::HighFirst);
+  std::fill(results.begin(), results.end(), 0.0F);
+  gatur::get(results.data(), registers.data(), count, WordOrder::HighFirst);
+  EXPECT_EQ(values, results);
+
+  /* The swapped layout is the plain one with the words of each value reversed */
+  std::vector<uint16_t> plain(2 * count);
+  gatur::put(plain.data(), values.data(), count, WordOrder::LowFirst);
+  for (size_t i = 0; i < count; i++) {
+    EXPECT_EQ(plain[2 * i], registers[2 * i + 1]);
+    EXPECT_EQ(plain[2 * i + 1], registers[2 * i]);
+  }
+}
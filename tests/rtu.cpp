@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+
+#include <gos/utils/rtu.h>
+
+namespace gaturt = ::gos::arduino::testing::utils::rtu;
+
+TEST(RtuTest, Timing) {
+  gaturt::Timing slow(9600);
+  EXPECT_EQ(1146, slow.Character);
+  EXPECT_EQ(1719, slow.Interchar);
+  EXPECT_EQ(4011, slow.Interframe);
+
+  gaturt::Timing fast(115200);
+  EXPECT_EQ(96, fast.Character);
+  EXPECT_EQ(750, fast.Interchar);
+  EXPECT_EQ(1750, fast.Interframe);
+}
+
+TEST(RtuTest, Line) {
+  const uint8_t frame[] = { 0x01, 0x03, 0x00, 0x00, 0x00, 0x01 };
+  uint8_t received[sizeof(frame)];
+  gaturt::Clock clock;
+  gaturt::Line line(clock, 9600);
+  const uint32_t character = line.timing().Character;
+
+  line.send(frame, sizeof(frame));
+  EXPECT_EQ(0, line.available());
+  EXPECT_EQ(character, line.next());
+  EXPECT_EQ(sizeof(frame) * character, line.idle());
+
+  clock.advance(character);
+  EXPECT_EQ(1, line.available());
+  clock.advance(2 * character);
+  EXPECT_EQ(3, line.available());
+  EXPECT_EQ(2, line.read(received, 2));
+  EXPECT_EQ(2 * character, line.last());
+  EXPECT_EQ(3 * character, line.next());
+  EXPECT_EQ(1, line.available());
+
+  /* A second burst queues behind the first one */
+  line.send(frame, 2);
+  EXPECT_EQ(8 * character, line.idle());
+  clock.until(line.idle());
+  EXPECT_EQ(6, line.available());
+  EXPECT_EQ(4, line.read(received + 2, 4));
+  EXPECT_EQ(0x01, received[5]);
+  EXPECT_EQ(2, line.read(received, sizeof(received)));
+  EXPECT_EQ(0x03, received[1]);
+  EXPECT_EQ(8 * character, line.last());
+  EXPECT_EQ(8, line.Sent);
+  EXPECT_EQ(8, line.Received);
+
+  /* Nothing is lost while the line is idle and the clock never goes back */
+  clock.until(0);
+  EXPECT_EQ(8 * character, clock.micros());
+  line.send(frame, 1);
+  EXPECT_EQ(9 * character, line.next());
+}
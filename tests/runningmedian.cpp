@@ -0,0 +1,92 @@
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gos/utils/lcg.h>
+#include <gos/utils/median.h>
+
+#define RUNNING_MEDIAN_COUNT 2048
+
+namespace gos {
+namespace arduino {
+namespace testing {
+namespace median {
+
+static uint32_t random(uint64_t& state, const uint32_t& range) {
+  return static_cast<uint32_t>((utils::lcg::next(state) >> 33) % range);
+}
+
+/* Copy and sort the window, what the device does on every get */
+template<typename T> T reference(const std::vector<T>& window) {
+  std::vector<T> sorted(window);
+  std::sort(sorted.begin(), sorted.end());
+  if (sorted.empty()) {
+    return T();
+  }
+  if (sorted.size() % 2) {
+    return sorted[sorted.size() / 2];
+  }
+  return (sorted[sorted.size() / 2] + sorted[sorted.size() / 2 - 1]) / T(2);
+}
+
+}
+}
+}
+}
+
+namespace gatm = ::gos::arduino::testing::median;
+namespace gatus = ::gos::arduino::testing::utils::statistics;
+
+TEST(RunningMedianTest, Median) {
+  const uint16_t sizes[] = { 1, 2, 3, 16, 64, 255, 256 };
+  for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    uint16_t size = sizes[s];
+    gatus::RunningMedian<double, uint16_t> median(size);
+    EXPECT_DOUBLE_EQ(0.0, median.get());
+    std::vector<double> window;
+    uint64_t state = size;
+    for (int i = 0; i < RUNNING_MEDIAN_COUNT; i++) {
+      double value = gatm::random(state, 1 << 20) / 1024.0;
+      median.add(value);
+      if (window.size() == size) {
+        window.erase(window.begin());
+      }
+      window.push_back(value);
+      ASSERT_EQ(window.size(), median.Count);
+      ASSERT_DOUBLE_EQ(gatm::reference(window), median.get()) << size;
+    }
+  }
+
+  /* Narrow range so the window is full of equal samples */
+  gatus::RunningMedian<uint32_t, uint8_t> counts(16);
+  std::vector<uint32_t> window;
+  uint64_t state = 1;
+  for (int i = 0; i < RUNNING_MEDIAN_COUNT; i++) {
+    uint32_t value = gatm::random(state, 4);
+    counts.add(value);
+    if (window.size() == 16) {
+      window.erase(window.begin());
+    }
+    window.push_back(value);
+    ASSERT_EQ(gatm::reference(window), counts.get());
+  }
+
+  counts.clear();
+  EXPECT_EQ(0, counts.Count);
+  counts.add(7);
+  EXPECT_EQ(7, counts.get());
+}
+
+TEST(RunningMedianTest, Slots) {
+  /* Values keeps the slot order of a running window */
+  gatus::RunningMedian<int, uint8_t> median(3);
+  for (int i = 1; i <= 5; i++) {
+    median.add(i);
+  }
+  ASSERT_EQ(3, median.Values.size());
+  EXPECT_EQ(4, median.Values[0]);
+  EXPECT_EQ(5, median.Values[1]);
+  EXPECT_EQ(3, median.Values[2]);
+  EXPECT_EQ(4, median.get());
+}
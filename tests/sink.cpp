@@ -0,0 +1,60 @@
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <gos/utils/sink.h>
+
+namespace gatu = ::gos::arduino::testing::utils;
+
+static size_t write(gatu::Sink& sink, const char* text) {
+  return sink.write(reinterpret_cast<const uint8_t*>(text), ::strlen(text));
+}
+
+TEST(SinkTest, Buffer) {
+  gatu::BufferSink sink;
+  EXPECT_EQ(0, sink.size());
+  EXPECT_EQ(5, write(sink, "hello"));
+  EXPECT_EQ(1, sink.write(reinterpret_cast<const uint8_t*>("\0"), 1));
+  EXPECT_EQ(6, write(sink, " world"));
+  EXPECT_EQ(12, sink.size());
+  EXPECT_EQ(std::string("hello\0 world", 12), sink.str());
+  sink.clear();
+  EXPECT_EQ(0, sink.size());
+}
+
+TEST(SinkTest, Ring) {
+  gatu::RingSink sink(8);
+  EXPECT_EQ(8, sink.capacity());
+  write(sink, "abcde");
+  EXPECT_EQ("abcde", sink.str());
+  EXPECT_EQ(0, sink.Overwritten);
+
+  /* Wraps and drops the oldest bytes */
+  write(sink, "fghij");
+  EXPECT_EQ(8, sink.size());
+  EXPECT_EQ("cdefghij", sink.str());
+  EXPECT_EQ(2, sink.Overwritten);
+
+  /* A span longer than the ring keeps only its tail */
+  EXPECT_EQ(11, write(sink, "0123456789x"));
+  EXPECT_EQ("3456789x", sink.str());
+  EXPECT_EQ(13, sink.Overwritten);
+
+  sink.clear();
+  write(sink, "ab");
+  EXPECT_EQ("ab", sink.str());
+}
+
+TEST(SinkTest, Descriptor) {
+  FILE* file = ::tmpfile();
+  ASSERT_NE(nullptr, file);
+  gatu::DescriptorSink sink(::fileno(file));
+  EXPECT_EQ(9, write(sink, "serial 42"));
+  ::rewind(file);
+  char text[16] = { 0 };
+  EXPECT_EQ(9, ::fread(text, 1, sizeof(text), file));
+  EXPECT_STREQ("serial 42", text);
+  ::fclose(file);
+}
@@ -0,0 +1,292 @@
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <Arduino.h>
+#include <SPI.h>
+
+namespace gatus = ::gos::arduino::testing::utils::spi;
+
+class SpiMockTest : public ::testing::Test {
+protected:
+
+  void SetUp() {
+    spimock = spiMockInstance();
+  }
+
+  void TearDown() {
+    releaseSpiMock();
+  }
+
+  SpiMock* spimock;
+};
+
+TEST_F(SpiMockTest, TransferBuffer) {
+  uint8_t buffer[] = { 0x80, 0x01, 0x02, 0x03 };
+  const uint8_t miso[] = { 0x00, 0xaf, 0x10 };
+  uint8_t mosi[sizeof(buffer)];
+
+  spimock->Out.pushbytes(miso, sizeof(miso));
+  spimock->Fill = 0xff;
+
+  SPI.transfer(buffer, sizeof(buffer));
+
+  EXPECT_EQ(miso[0], buffer[0]);
+  EXPECT_EQ(miso[1], buffer[1]);
+  EXPECT_EQ(miso[2], buffer[2]);
+  EXPECT_EQ(0xff, buffer[3]);
+  EXPECT_EQ(1, spimock->Underrun);
+  EXPECT_EQ(0, spimock->Out.bytes());
+
+  EXPECT_EQ(sizeof(mosi), spimock->In.popbytes(mosi, sizeof(mosi)));
+  EXPECT_EQ(0x80, mosi[0]);
+  EXPECT_EQ(0x01, mosi[1]);
+  EXPECT_EQ(0x02, mosi[2]);
+  EXPECT_EQ(0x03, mosi[3]);
+}
+
+TEST_F(SpiMockTest, TransferUnderrun) {
+  uint8_t result8;
+  uint16_t result16;
+
+  result8 = SPI.transfer(0x12);
+  EXPECT_EQ(0x00, result8);
+  EXPECT_EQ(1, spimock->Underrun);
+
+  spimock->Fill = 0xa5;
+  spimock->Out.pushbyte(0x3c);
+  result16 = SPI.transfer16(0x3456);
+  EXPECT_EQ(0x3ca5, result16);
+  EXPECT_EQ(2, spimock->Underrun);
+
+  spimock->Out.pushword(0x1234);
+  result16 = SPI.transfer16(0x0000);
+  EXPECT_EQ(0x1234, result16);
+  EXPECT_EQ(2, spimock->Underrun);
+  EXPECT_EQ(5, spimock->In.bytes());
+
+  /* The fill byte lands in the word the way Out orders its bytes */
+  spimock->Out = ::gos::arduino::testing::utils::WordQueue(
+    ::gos::arduino::testing::utils::byte::Order::LittleEndian);
+  spimock->Out.pushword(0x1234);
+  EXPECT_EQ(0x1234, SPI.transfer16(0x0000));
+  spimock->Out.pushbyte(0x3c);
+  EXPECT_EQ(0xa53c, SPI.transfer16(0x0000));
+  EXPECT_EQ(3, spimock->Underrun);
+}
+
+TEST_F(SpiMockTest, Max31865Device) {
+  const uint8_t pin = 9;
+  uint8_t buffer[9];
+  gatus::Max31865 max31865;
+  spimock->attach(pin, &max31865);
+  max31865.rtd(0x10ff >> 1);
+  max31865.Registers[gatus::Max31865::Configuration] = 0xaf;
+
+  /* Not selected, the bytes come from Out */
+  EXPECT_EQ(0x00, SPI.transfer(0x00));
+  EXPECT_EQ(1, spimock->Underrun);
+
+  /* Write the configuration register */
+  spimock->chipselect(pin, LOW);
+  SPI.transfer(0x80);
+  SPI.transfer(0xc2 | 0x10);
+  spimock->chipselect(pin, HIGH);
+  EXPECT_EQ(0xd0, max31865.Registers[gatus::Max31865::Configuration]);
+
+  /* Full register read in one block */
+  ::memset(buffer, 0x00, sizeof(buffer));
+  spimock->chipselect(pin, LOW);
+  SPI.transfer(buffer, sizeof(buffer));
+  spimock->chipselect(pin, HIGH);
+  EXPECT_EQ(0xd0, buffer[1]);
+  EXPECT_EQ(0x10ff, ((buffer[2] << 8) | buffer[3]) | 0x0001);
+  EXPECT_EQ(0xff, buffer[4]);
+  EXPECT_EQ(0x00, buffer[8]);
+  EXPECT_EQ(1, spimock->Underrun);
+
+  spimock->detach(pin);
+}
+
+TEST_F(SpiMockTest, Max6675Device) {
+  const uint8_t pin = 10;
+  gatus::Max6675 max6675;
+  spimock->attach(pin, &max6675);
+  spimock->Capture = false;
+
+  max6675.open(true);
+  spimock->chipselect(pin, LOW);
+  EXPECT_EQ(0x0004, SPI.transfer16(0x0000));
+  spimock->chipselect(pin, HIGH);
+
+  max6675.open(false);
+  max6675.temperature(32.0);
+  spimock->chipselect(pin, LOW);
+  EXPECT_EQ(0x04, SPI.transfer(0x00));
+  EXPECT_EQ(0x00, SPI.transfer(0x00));
+  spimock->chipselect(pin, HIGH);
+
+  EXPECT_EQ(0, spimock->In.bytes());
+  EXPECT_EQ(0, spimock->Underrun);
+}
+
+TEST_F(SpiMockTest, Mcp3208Device) {
+  const uint8_t pin = 8;
+  gatus::Mcp3208 mcp3208;
+  spimock->attach(pin, &mcp3208);
+  for (uint8_t channel = 0; channel < gatus::Mcp3208::ChannelCount; channel++) {
+    mcp3208.Single[channel] = 0x0a5c + channel;
+  }
+  mcp3208.Differential[1] = 0x0123;
+
+  for (uint8_t channel = 0; channel < gatus::Mcp3208::ChannelCount; channel++) {
+    uint8_t buffer[] = {
+      static_cast<uint8_t>(0x06 | (channel >> 2)),
+      static_cast<uint8_t>((channel & 0x03) << 6),
+      0x00 };
+    spimock->chipselect(pin, LOW);
+    SPI.transfer(buffer, sizeof(buffer));
+    spimock->chipselect(pin, HIGH);
+    EXPECT_EQ(0x0a5c + channel, ((buffer[1] & 0x0f) << 8) | buffer[2]);
+  }
+
+  /* Differential CH0 = IN- CH1 = IN+ with the start bit last in a byte */
+  spimock->chipselect(pin, LOW);
+  EXPECT_EQ(0x00, SPI.transfer(0x01));
+  EXPECT_EQ(0x00, SPI.transfer(0x10));
+  EXPECT_EQ(0x0123 >> 2, SPI.transfer(0x00));
+  /* B1 B0 and then the LSB first repeat B1..B6 */
+  EXPECT_EQ(0xe2, SPI.transfer(0x00));
+  spimock->chipselect(pin, HIGH);
+}
+
+TEST(SpiMockThreadTest, Instance) {
+  const size_t count = 8;
+  const size_t bytes = 4096;
+  std::vector<std::thread> threads;
+  std::vector<size_t> results(count, 0);
+  for (size_t t = 0; t < count; t++) {
+    threads.push_back(std::thread([t, &results]() {
+      SpiMock* spimock = spiMockInstance();
+      uint8_t tag = static_cast<uint8_t>(t);
+      for (size_t i = 0; i < bytes; i++) {
+        spimock->Out.pushbyte(tag);
+      }
+      size_t matched = 0;
+      for (size_t i = 0; i < bytes; i++) {
+        if (SPI.transfer(tag) == tag) {
+          matched++;
+        }
+      }
+      if (spimock->In.bytes() == bytes && spimock->Underrun == 0) {
+        results[t] = matched;
+      }
+      releaseSpiMock();
+    }));
+  }
+  for (size_t t = 0; t < count; t++) {
+    threads[t].join();
+    EXPECT_EQ(bytes, results[t]);
+  }
+}
+
+TEST_F(SpiMockTest, Timing) {
+  const uint8_t pina = 8;
+  const uint8_t pinb = 9;
+  uint8_t buffer[9];
+
+  EXPECT_EQ(8000000, SPISettings(F_CPU, MSBFIRST, SPI_MODE0).frequency());
+  EXPECT_EQ(4000000, SPISettings().frequency());
+  EXPECT_EQ(1000000, SPISettings(1000000, MSBFIRST, SPI_MODE0).frequency());
+  EXPECT_EQ(250000, SPISettings(F_CPU / 64, MSBFIRST, SPI_MODE1).frequency());
+  EXPECT_EQ(125000, SPISettings(1000, MSBFIRST, SPI_MODE0).frequency());
+
+  SPI.beginTransaction(SPISettings(1000000, MSBFIRST, SPI_MODE0));
+  spimock->chipselect(pina, LOW);
+  SPI.transfer(buffer, sizeof(buffer));
+  spimock->chipselect(pina, HIGH);
+  SPI.endTransaction();
+
+  SPI.beginTransaction(SPISettings(F_CPU / 64, MSBFIRST, SPI_MODE1));
+  spimock->chipselect(pinb, LOW);
+  SPI.transfer16(0x0000);
+  spimock->chipselect(pinb, HIGH);
+  spimock->chipselect(pinb, LOW);
+  SPI.transfer16(0x0000);
+  spimock->chipselect(pinb, HIGH);
+  SPI.endTransaction();
+
+  EXPECT_EQ(9, spimock->Statistics[pina].Bytes);
+  EXPECT_EQ(1, spimock->Statistics[pina].Transactions);
+  EXPECT_DOUBLE_EQ(72.0, spimock->Statistics[pina].microseconds());
+  EXPECT_EQ(4, spimock->Statistics[pinb].Bytes);
+  EXPECT_EQ(2, spimock->Statistics[pinb].Transactions);
+  EXPECT_DOUBLE_EQ(128.0, spimock->Statistics[pinb].microseconds());
+  EXPECT_EQ(200000, spimock->Nanoseconds);
+
+  /* Default settings outside of a transaction and no chip select */
+  SPI.transfer(0x00);
+  EXPECT_EQ(1, spimock->Statistics[SPI_NO_CHIP_SELECT].Bytes);
+  EXPECT_EQ(2000, spimock->Statistics[SPI_NO_CHIP_SELECT].Nanoseconds);
+}
+
+TEST_F(SpiMockTest, BitOrder) {
+  const uint8_t pin = 9;
+  uint8_t buffer[12];
+  uint8_t mosi[sizeof(buffer)];
+  gatus::Max31865 max31865;
+  spimock->attach(pin, &max31865);
+  max31865.Registers[gatus::Max31865::Configuration] = 0xc1;
+
+  for (uint8_t i = 0; i < sizeof(buffer); i++) {
+    EXPECT_EQ(i, ::gos::arduino::testing::utils::bit::reverse(
+      ::gos::arduino::testing::utils::bit::reverse(i)));
+  }
+  EXPECT_EQ(0x80, ::gos::arduino::testing::utils::bit::reverse(0x01));
+  EXPECT_EQ(0x3b, ::gos::arduino::testing::utils::bit::reverse(0xdc));
+
+  /* A driver misconfigured for LSB first reading the fault status
+     register ends up writing the configuration register */
+  SPI.beginTransaction(SPISettings(1000000, LSBFIRST, SPI_MODE1));
+  spimock->chipselect(pin, LOW);
+  buffer[0] = gatus::Max31865::FaultStatus;
+  buffer[1] = 0x00;
+  SPI.transfer(buffer, 2);
+  spimock->chipselect(pin, HIGH);
+  SPI.endTransaction();
+  EXPECT_EQ(0x00, max31865.Registers[gatus::Max31865::Configuration]);
+  EXPECT_EQ(0, spimock->Mismatch);
+  max31865.Registers[gatus::Max31865::Configuration] = 0xc1;
+
+  /* Wrong mode */
+  SPI.beginTransaction(SPISettings(1000000, MSBFIRST, SPI_MODE0));
+  spimock->chipselect(pin, LOW);
+  ::memset(buffer, 0x00, sizeof(buffer));
+  SPI.transfer(buffer, 2);
+  spimock->chipselect(pin, HIGH);
+  SPI.endTransaction();
+  EXPECT_EQ(0xc1, buffer[1]);
+  EXPECT_EQ(2, spimock->Mismatch);
+  spimock->In.clear();
+
+  /* LSB first on the wire, the captured bytes are in wire order */
+  spimock->detach(pin);
+  for (uint8_t i = 0; i < sizeof(buffer); i++) {
+    buffer[i] = i;
+    spimock->Out.pushbyte(::gos::arduino::testing::utils::bit::reverse(0x80 | i));
+  }
+  /* transfer16 shifts the low byte first */
+  spimock->Out.pushbyte(::gos::arduino::testing::utils::bit::reverse(0x34));
+  spimock->Out.pushbyte(::gos::arduino::testing::utils::bit::reverse(0x12));
+  SPI.beginTransaction(SPISettings(1000000, LSBFIRST, SPI_MODE0));
+  SPI.transfer(buffer, sizeof(buffer));
+  EXPECT_EQ(0x1234, SPI.transfer16(0x0000));
+  SPI.endTransaction();
+  EXPECT_EQ(sizeof(buffer), spimock->In.popbytes(mosi, sizeof(buffer)));
+  for (uint8_t i = 0; i < sizeof(buffer); i++) {
+    EXPECT_EQ(0x80 | i, buffer[i]);
+    EXPECT_EQ(::gos::arduino::testing::utils::bit::reverse(i), mosi[i]);
+  }
+}
@@ -0,0 +1,189 @@
+#include <climits>
+#include <string>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include <gos/utils/heap.h>
+#include <gos/utils/sink.h>
+
+#include <WAString.h>
+
+namespace gatu = ::gos::arduino::testing::utils;
+namespace gam = ::gos::arduino::mock;
+
+TEST(StringTest, Storage) {
+  String text("serial");
+  EXPECT_EQ(6, text.length());
+  EXPECT_STREQ("serial", text.c_str());
+
+  /* Growing past the inline buffer keeps the content */
+  for (int i = 0; i < 100; i++) {
+    text += "abc";
+  }
+  EXPECT_EQ(306, text.length());
+  text += text;
+  EXPECT_EQ(612, text.length());
+  EXPECT_TRUE(text.startsWith("serialabc"));
+  EXPECT_TRUE(text.endsWith("abcabc"));
+
+  String moved(std::move(text));
+  EXPECT_EQ(612, moved.length());
+  EXPECT_EQ(0, text.length());
+  EXPECT_STREQ("", text.c_str());
+
+  String copy;
+  copy = moved;
+  EXPECT_TRUE(copy == moved);
+  EXPECT_TRUE(copy.reserve(1000));
+  EXPECT_TRUE(copy == moved);
+}
+
+TEST(StringTest, Arena) {
+  gatu::Heap heap(64);
+  String::arena(&heap);
+  {
+    String first("0123456789");
+    String second("0123456789012345678901234567890123456789");
+    EXPECT_EQ(2, heap.Allocations);
+
+    /* The device would be out of memory here as well */
+    String third("0123456789");
+    EXPECT_EQ(1, heap.Failures);
+    EXPECT_EQ(0, third.length());
+
+    /* first cannot grow in place and there is no room to move it */
+    first += "xx";
+    EXPECT_STREQ("0123456789", first.c_str());
+
+    /* A move between strings on the same arena takes the buffer */
+    uint64_t allocations = heap.Allocations;
+    String moved(std::move(second));
+    EXPECT_EQ(allocations, heap.Allocations);
+    EXPECT_EQ(40, moved.length());
+  }
+  EXPECT_EQ(0, heap.used());
+  String::arena(nullptr);
+}
+
+TEST(StringTest, Numbers) {
+  EXPECT_STREQ("-42", String(-42).c_str());
+  EXPECT_STREQ("ff", String(255, HEX).c_str());
+  EXPECT_STREQ("101", String(5u, BIN).c_str());
+  EXPECT_STREQ("3.142", String(3.14159, 3).c_str());
+
+  String text("t=");
+  text += 21;
+  text += ' ';
+  text += -7L;
+  text += ' ';
+  text += 1.5f;
+  EXPECT_STREQ("t=21 -7 1.50", text.c_str());
+
+  /* Many decimals and large values need more room than the digits buffer */
+  String decimals(1.5, 40);
+  EXPECT_EQ(42, decimals.length());
+  EXPECT_TRUE(decimals.startsWith("1.5000"));
+  String large(1.0e30, 2);
+  EXPECT_EQ(34, large.length());
+  EXPECT_TRUE(large.endsWith(".00"));
+  EXPECT_TRUE(large == String(1.0e30F, 2));
+  text = "";
+  text += 1.0e30;
+  EXPECT_TRUE(large == text);
+}
+
+TEST(StringTest, Print) {
+  gam::Print print;
+  print.print("a");
+  print.print(-42);
+  print.print(' ');
+  print.print(255, HEX);
+  print.print(' ');
+  print.print(-1.995, 2);
+  print.println(3.25, 0);
+  EXPECT_EQ("a-42 FF -2.003\r\n", print.buffer().str());
+
+  print.buffer().clear();
+  print.print(LONG_MIN);
+  EXPECT_EQ(std::to_string(LONG_MIN), print.buffer().str());
+
+  gatu::RingSink ring(4);
+  print.sink(&ring);
+  print.print(123456);
+  EXPECT_EQ("3456", ring.str());
+  EXPECT_EQ(2, ring.Overwritten);
+}
+
+TEST(StringTest, Search) {
+  String text("set speed=10; set mode=auto;");
+  EXPECT_EQ(3, text.indexOf(' '));
+  EXPECT_EQ(13, text.indexOf(' ', 4));
+  EXPECT_EQ(-1, text.indexOf('#'));
+  EXPECT_EQ(-1, text.indexOf(' ', 100));
+  EXPECT_EQ(0, text.indexOf("set"));
+  EXPECT_EQ(14, text.indexOf("set", 1));
+  EXPECT_EQ(-1, text.indexOf("speed", 5));
+  EXPECT_EQ(27, text.lastIndexOf(';'));
+  EXPECT_EQ(12, text.lastIndexOf(';', 26));
+  EXPECT_EQ(14, text.lastIndexOf("set"));
+  EXPECT_EQ(0, text.lastIndexOf("set", 13));
+  EXPECT_EQ(-1, String("ab").lastIndexOf("abc"));
+  EXPECT_FALSE(String("ab").startsWith(String("abababababababababababababababababababababababab"), 0));
+  EXPECT_FALSE(String("ab").startsWith("abc"));
+  EXPECT_TRUE(text.startsWith("speed", 4));
+  EXPECT_FALSE(text.startsWith("speed", 25));
+
+  int equals = text.indexOf('=');
+  EXPECT_EQ(10, text.substring(equals + 1, text.indexOf(';')).toInt());
+  EXPECT_STREQ("auto;", text.substring(text.lastIndexOf('=') + 1).c_str());
+}
+
+TEST(StringTest, Modify) {
+  String text("a-b-c");
+  text.replace('-', '+');
+  EXPECT_STREQ("a+b+c", text.c_str());
+
+  /* Equal length, shorter and longer replacements */
+  text = "one two one";
+  text.replace("one", "six");
+  EXPECT_STREQ("six two six", text.c_str());
+  text.replace("six", "1");
+  EXPECT_STREQ("1 two 1", text.c_str());
+  text.replace("1", "eleven");
+  EXPECT_STREQ("eleven two eleven", text.c_str());
+  text = "aaa";
+  text.replace("aa", "b");
+  EXPECT_STREQ("ba", text.c_str());
+  text = "aaa";
+  text.replace("aa", "bbb");
+  EXPECT_STREQ("bbba", text.c_str());
+
+  text = "0123456789";
+  text.remove(7);
+  EXPECT_STREQ("0123456", text.c_str());
+  text.remove(1, 2);
+  EXPECT_STREQ("03456", text.c_str());
+  text.remove(3, 100);
+  EXPECT_STREQ("034", text.c_str());
+  text.remove(10);
+  EXPECT_STREQ("034", text.c_str());
+
+  text = " \t Mode AUTO \r\n";
+  text.trim();
+  EXPECT_STREQ("Mode AUTO", text.c_str());
+  text.toLowerCase();
+  EXPECT_STREQ("mode auto", text.c_str());
+  text.toUpperCase();
+  EXPECT_STREQ("MODE AUTO", text.c_str());
+  text = "   ";
+  text.trim();
+  EXPECT_EQ(0, text.length());
+}
+
+TEST(StringTest, Conversion) {
+  EXPECT_EQ(-123, String("-123abc").toInt());
+  EXPECT_EQ(0, String("abc").toInt());
+  EXPECT_FLOAT_EQ(2.5f, String("2.5").toFloat());
+  EXPECT_DOUBLE_EQ(-0.125, String(" -0.125").toDouble());
+}
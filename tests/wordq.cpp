@@ -0,0 +1,156 @@
+#include <cstring>
+
+#include <gtest/gtest.h>
+
+#include <gos/utils/wordq.h>
+
+namespace gatu = ::gos::arduino::testing::utils;
+namespace gatub = ::gos::arduino::testing::utils::byte;
+
+TEST(WordQueueTest, Bytes) {
+  bool popresult;
+  uint8_t value;
+  gatu::WordQueue queue;
+
+  queue.pushbyte(0x12);
+  queue.pushbyte(0x34);
+  EXPECT_EQ(2, queue.bytes());
+  EXPECT_EQ(1, queue.words());
+
+  popresult = queue.popbyte(value);
+  EXPECT_TRUE(popresult);
+  EXPECT_EQ(0x12, value);
+  popresult = queue.popbyte(value);
+  EXPECT_TRUE(popresult);
+  EXPECT_EQ(0x34, value);
+  popresult = queue.popbyte(value);
+  EXPECT_FALSE(popresult);
+}
+
+TEST(WordQueueTest, Words) {
+  uint16_t value;
+  gatu::WordQueue bigendian(gatub::Order::BigEndian);
+  gatu::WordQueue littleendian(gatub::Order::LittleEndian);
+  const uint16_t words[] = { 0x10ff, 0x20fe, 0x40fd };
+  uint16_t popped[3];
+  uint8_t bytes[6];
+
+  bigendian.pushwords(words, 3);
+  EXPECT_EQ(6, bigendian.popbytes(bytes, sizeof(bytes)));
+  EXPECT_EQ(0x10, bytes[0]);
+  EXPECT_EQ(0xff, bytes[1]);
+  EXPECT_EQ(0xfd, bytes[5]);
+
+  littleendian.pushwords(words, 3);
+  EXPECT_EQ(6, littleendian.popbytes(bytes, sizeof(bytes)));
+  EXPECT_EQ(0xff, bytes[0]);
+  EXPECT_EQ(0x10, bytes[1]);
+  EXPECT_EQ(0x40, bytes[5]);
+
+  bigendian.pushwords(words, 3);
+  EXPECT_EQ(3, bigendian.popwords(popped, 3));
+  EXPECT_EQ(words[0], popped[0]);
+  EXPECT_EQ(words[1], popped[1]);
+  EXPECT_EQ(words[2], popped[2]);
+
+  bigendian.pushbyte(0x01);
+  EXPECT_FALSE(bigendian.popword(value));
+  EXPECT_EQ(0, bigendian.popwords(popped, 3));
+  EXPECT_EQ(1, bigendian.bytes());
+}
+
+TEST(WordQueueTest, Wrap) {
+  const size_t capacity = 8;
+  gatu::WordQueue queue(gatub::Order::BigEndian, capacity);
+  uint8_t data[capacity], popped[capacity];
+  for (uint8_t i = 0; i < capacity; i++) {
+    data[i] = i;
+  }
+
+  /* Move the head so the next bulk push wraps around the end */
+  queue.pushbytes(data, 5);
+  EXPECT_EQ(5, queue.drop(5));
+  queue.pushbytes(data, capacity);
+  EXPECT_EQ(capacity, queue.capacity());
+  EXPECT_EQ(capacity, queue.bytes());
+
+  /* The two segment view leaves the ring as it is */
+  gatu::Span first, second;
+  queue.peek(first, second);
+  EXPECT_EQ(3, first.size);
+  EXPECT_EQ(5, second.size);
+  EXPECT_EQ(first.data - 5, second.data);
+  EXPECT_EQ(0, first.data[0]);
+  EXPECT_EQ(3, second.data[0]);
+
+  gatu::Span span = queue.peek();
+  EXPECT_EQ(capacity, span.size);
+  for (size_t i = 0; i < capacity; i++) {
+    EXPECT_EQ(data[i], span.data[i]);
+  }
+  EXPECT_EQ(capacity, queue.bytes());
+
+  EXPECT_EQ(capacity, queue.popbytes(popped, capacity));
+  for (size_t i = 0; i < capacity; i++) {
+    EXPECT_EQ(data[i], popped[i]);
+  }
+  EXPECT_EQ(0, queue.bytes());
+}
+
+TEST(WordQueueTest, Grow) {
+  const size_t count = 1000;
+  gatu::WordQueue queue(gatub::Order::BigEndian, 4);
+  uint16_t value;
+
+  queue.pushbyte(0xaa);
+  for (uint16_t i = 0; i < count; i++) {
+    queue.pushword(i);
+  }
+  EXPECT_EQ(1 + 2 * count, queue.bytes());
+  EXPECT_LE(1 + 2 * count, queue.capacity());
+
+  EXPECT_EQ(1, queue.drop(1));
+  for (uint16_t i = 0; i < count; i++) {
+    EXPECT_TRUE(queue.popword(value));
+    EXPECT_EQ(i, value);
+  }
+  EXPECT_EQ(0, queue.bytes());
+
+  queue.pushbyte(0x55);
+  queue.clear();
+  EXPECT_EQ(0, queue.bytes());
+  EXPECT_EQ(0, queue.peek().size);
+}
+
+TEST(WordQueueTest, Prepare) {
+  const size_t capacity = 8;
+  gatu::WordQueue queue(gatub::Order::BigEndian, capacity);
+  uint8_t data[capacity], popped[capacity];
+  uint8_t* space;
+  for (uint8_t i = 0; i < capacity; i++) {
+    data[i] = i;
+  }
+
+  /* Free space wrapping around the end is made contiguous */
+  queue.pushbytes(data, 6);
+  EXPECT_EQ(4, queue.drop(4));
+  space = queue.prepare(5);
+  ::memcpy(space, data + 2, 5);
+  queue.commit(5);
+  EXPECT_EQ(7, queue.bytes());
+  EXPECT_EQ(capacity, queue.capacity());
+  EXPECT_EQ(7, queue.popbytes(popped, capacity));
+  EXPECT_EQ(4, popped[0]);
+  EXPECT_EQ(5, popped[1]);
+  for (size_t i = 2; i < 7; i++) {
+    EXPECT_EQ(data[i], popped[i]);
+  }
+
+  /* Only the committed part becomes content and the ring grows */
+  space = queue.prepare(2 * capacity);
+  EXPECT_LE(2 * capacity, queue.capacity());
+  space[0] = 0xaa;
+  queue.commit(1);
+  EXPECT_EQ(1, queue.bytes());
+  EXPECT_EQ(0xaa, queue.peek().data[0]);
+}